@@ -0,0 +1,206 @@
+#include <benchmark/benchmark.h>
+#include <cryptopp/filters.h>
+#include <cryptopp/hex.h>
+#include <cryptopp/modes.h>
+#include <cryptopp/rijndael.h>
+
+#include <cstring>
+
+#include "src/aes_batch_crypto.hpp"
+#include "src/aes_crypto.hpp"
+#include "src/aes_ctr_crypto.hpp"
+
+BENCHMARK_MAIN();
+
+namespace {
+
+constexpr const char *key { "hellohellohellohellohellohelloh!" };
+
+std::string make_text(std::size_t size) {
+  std::string text(size, '\0');
+  for (std::size_t i {}; i < size; ++i) {
+    text[i] = static_cast<char>(i * 7);
+  }
+  return text;
+}
+
+template <class Transform>
+void run(benchmark::State &state, Transform transform) {
+  const auto text { make_text(state.range(0)) };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(transform(text).size());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+// The StringSource pipeline AESCryptoStrategy ran before it encrypted in place, kept as the baseline for the rest.
+void ecb_encrypt_pipeline(benchmark::State &state) {
+  CryptoPP::ECB_Mode<CryptoPP::AES>::Encryption encryptor;
+  run(state, [&](auto &&text) {
+    encryptor.SetKey(reinterpret_cast<const CryptoPP::byte *>(key), std::strlen(key));
+    std::string result;
+    const auto encoder { new CryptoPP::HexEncoder { new CryptoPP::StringSink { result } } };
+    const CryptoPP::StringSource source { text, true, new CryptoPP::StreamTransformationFilter { encryptor, encoder } };
+    return result;
+  });
+}
+
+void ecb_decrypt_pipeline(benchmark::State &state) {
+  CryptoPP::ECB_Mode<CryptoPP::AES>::Decryption decryptor;
+  const auto encrypted { AESCryptoStrategy {}.encrypt(make_text(state.range(0)), key) };
+  run(state, [&](auto &&) {
+    decryptor.SetKey(reinterpret_cast<const CryptoPP::byte *>(key), std::strlen(key));
+    std::string result;
+    const auto filter { new CryptoPP::StreamTransformationFilter { decryptor, new CryptoPP::StringSink { result } } };
+    const CryptoPP::StringSource source { encrypted, true, new CryptoPP::HexDecoder { filter } };
+    return result;
+  });
+}
+
+// AESCryptoStrategy on one thread with its default hex output.
+void ecb_encrypt(benchmark::State &state) {
+  AESCryptoStrategy crypto;
+  run(state, [&](auto &&text) { return crypto.encrypt(text, key); });
+}
+
+void ecb_decrypt(benchmark::State &state) {
+  AESCryptoStrategy crypto;
+  const auto encrypted { crypto.encrypt(make_text(state.range(0)), key) };
+  run(state, [&](auto &&) { return crypto.decrypt(encrypted, key); });
+}
+
+// Many small messages under one key, where the key expansion used to dominate.
+void ecb_encrypt_cached_key(benchmark::State &state) {
+  CryptoLibAESImplementation crypto;
+  run(state, [&](auto &&text) { return crypto.encrypt(text, key); });
+}
+
+void ecb_encrypt_cold_key(benchmark::State &state) {
+  CryptoLibAESImplementation crypto;
+  run(state, [&](auto &&text) {
+    crypto.forget_key(key);
+    return crypto.encrypt(text, key);
+  });
+}
+
+// The cipher with its output encoding, raw shows the cost of the cipher alone.
+void ecb_encrypt_encoded(benchmark::State &state, TextEncoding encoding) {
+  AESCryptoStrategy crypto { encoding };
+  run(state, [&](auto &&text) { return crypto.encrypt(text, key); });
+}
+
+void ecb_decrypt_encoded(benchmark::State &state, TextEncoding encoding) {
+  AESCryptoStrategy crypto { encoding };
+  const auto encrypted { crypto.encrypt(make_text(state.range(0)), key) };
+  run(state, [&](auto &&) { return crypto.decrypt(encrypted, key); });
+}
+
+void ctr_encrypt(benchmark::State &state) {
+  AESCTRCryptoStrategy crypto { static_cast<unsigned>(state.range(1)) };
+  run(state, [&](auto &&text) { return crypto.encrypt(text, key); });
+}
+
+void ctr_decrypt(benchmark::State &state) {
+  AESCTRCryptoStrategy crypto { static_cast<unsigned>(state.range(1)) };
+  const auto encrypted { crypto.encrypt(make_text(state.range(0)), key) };
+  run(state, [&](auto &&) { return crypto.decrypt(encrypted, key); });
+}
+
+// Many short records on one thread, range(0) bytes each: one record at a time against all blocks of a task in flight.
+RecordBatch make_records(std::size_t size) {
+  RecordBatch records;
+  for (auto index { 0 }; index < 4096; ++index) {
+    records.push_back(make_text(size));
+  }
+  return records;
+}
+
+void run_records(benchmark::State &state, auto encrypt) {
+  const auto records { make_records(state.range(0)) };
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encrypt(records).records.data.size());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(records.data.size()));
+}
+
+void batch_encrypt_records(benchmark::State &state) {
+  AESCryptoStrategy crypto { TextEncoding::RAW };
+  BatchCrypto batch { crypto, 1 };
+  run_records(state, [&](auto &&records) { return batch.encrypt(records, key); });
+}
+
+void multi_buffer_encrypt_records(benchmark::State &state) {
+  AESBatchCrypto batch { TextEncoding::RAW, 1 };
+  run_records(state, [&](auto &&records) { return batch.encrypt(records, key); });
+}
+
+void multi_buffer_encrypt_records_with_own_keys(benchmark::State &state) {
+  AESBatchCrypto batch { TextEncoding::RAW, 1 };
+  const std::array<const char *, 4> distinct_keys { key, "hellohellohelloh", "hellohellohellohellohell",
+                                                    "lemonlemonlemonlemonlemonlemonle" };
+  std::vector<const char *> keys;
+  for (auto index { 0 }; index < 4096; ++index) {
+    keys.push_back(distinct_keys[index % distinct_keys.size()]);
+  }
+  run_records(state, [&](auto &&records) { return batch.encrypt(records, keys); });
+}
+
+// The kernels alone on 4096 messages of range(0) blocks in place, sixteen blocks in flight with VAES against eight with
+// AES-NI.
+template <bool is_vaes>
+void multi_buffer_messages(benchmark::State &state) {
+  if (AESMultiBuffer::is_supported() == false || (is_vaes && CpuFeatures::has_vaes() == false)) {
+    state.SkipWithError("Not supported by this CPU.");
+    return;
+  }
+
+  const AESRoundKeys keys { key };
+  const auto message_size { state.range(0) * AESRoundKeys::block_size };
+  auto text { make_text(4096 * message_size) };
+  std::vector<AESMessageJob> jobs;
+  for (std::size_t offset {}; offset < text.size(); offset += message_size) {
+    auto *message { reinterpret_cast<std::uint8_t *>(text.data() + offset) };
+    jobs.push_back({ message, message, static_cast<std::size_t>(state.range(0)), &keys });
+  }
+
+  for (auto _ : state) {
+#ifdef CRYPTO_X86_KERNELS
+    if constexpr (is_vaes) {
+      AESMultiBuffer::run_vaes<true>(jobs, &keys);
+    } else {
+      AESMultiBuffer::run_aes_ni<true>(jobs, &keys);
+    }
+#endif
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+}  // namespace
+
+BENCHMARK(ecb_encrypt_pipeline)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK(ecb_decrypt_pipeline)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK(ecb_encrypt)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK(ecb_decrypt)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_encrypt_encoded, raw, TextEncoding::RAW)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_encrypt_encoded, hex, TextEncoding::HEX)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_encrypt_encoded, base64, TextEncoding::BASE64)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_decrypt_encoded, raw, TextEncoding::RAW)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_decrypt_encoded, hex, TextEncoding::HEX)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(ecb_decrypt_encoded, base64, TextEncoding::BASE64)->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+BENCHMARK(ecb_encrypt_cached_key)->Arg(16)->Arg(256);
+BENCHMARK(ecb_encrypt_cold_key)->Arg(16)->Arg(256);
+BENCHMARK(ctr_encrypt)->ArgsProduct({ { 1 << 20, 64 << 20 }, { 1, 2, 4, 8 } })->UseRealTime();
+BENCHMARK(ctr_decrypt)->ArgsProduct({ { 1 << 20, 64 << 20 }, { 1, 2, 4, 8 } })->UseRealTime();
+BENCHMARK(batch_encrypt_records)->Arg(64)->Arg(256)->UseRealTime();
+BENCHMARK(multi_buffer_encrypt_records)->Arg(64)->Arg(256)->UseRealTime();
+BENCHMARK(multi_buffer_encrypt_records_with_own_keys)->Arg(64)->Arg(256)->UseRealTime();
+BENCHMARK(multi_buffer_messages<false>)->Arg(1)->Arg(4)->Arg(17);
+BENCHMARK(multi_buffer_messages<true>)->Arg(1)->Arg(4)->Arg(17);
@@ -0,0 +1,100 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts every global operator new, the aligned and nothrow forms too. Replaces the global allocation functions, so
+// it must be included into exactly one translation unit of a benchmark executable.
+class AllocationCounter {
+ public:
+  static std::size_t get() noexcept { return count.load(std::memory_order_relaxed); }
+
+  static void add() noexcept { count.fetch_add(1, std::memory_order_relaxed); }
+
+  // Reports the allocations made since start as an average per iteration.
+  static void report(benchmark::State &state, std::size_t start) {
+    state.counters["allocs_per_op"] = benchmark::Counter { static_cast<double>(get() - start),
+                                                           benchmark::Counter::kAvgIterations };
+  }
+
+ private:
+  inline static std::atomic<std::size_t> count {};
+};
+
+void *operator new(std::size_t size) {
+  AllocationCounter::add();
+  if (auto *pointer { std::malloc(size == 0 ? 1 : size) }) {
+    return pointer;
+  }
+  throw std::bad_alloc {};
+}
+
+// std::aligned_alloc needs the size to be a multiple of the alignment.
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  AllocationCounter::add();
+  const auto align { static_cast<std::size_t>(alignment) };
+  if (auto *pointer { std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align) }) {
+    return pointer;
+  }
+  throw std::bad_alloc {};
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return operator new(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return operator new(size, std::nothrow);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  try {
+    return operator new(size, alignment);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return operator new(size, alignment, std::nothrow);
+}
+
+// Both malloc and aligned_alloc memory goes back through free, so every delete is the same.
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+#endif
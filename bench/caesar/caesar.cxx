@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <cctype>
+#include <functional>
+
+#include "src/caesar_crypto.hpp"
+
+BENCHMARK_MAIN();
+
+namespace {
+
+// The per-char std::function path the kernel replaced, kept as the baseline.
+class LegacyCaesar {
+ public:
+  std::string encrypt(const std::string &text, int shift) {
+    return parse(text, shift, [this](auto ch, auto shift) { return encrypt_char(ch, shift); });
+  }
+
+ private:
+  std::string parse(const std::string &text, int shift, std::function<char(char, int)> policy) {
+    std::string result;
+    for (auto &&ch : text) {
+      result += (std::ispunct(ch) || std::isspace(ch)) ? ch : policy(ch, shift);
+    }
+    return result;
+  }
+
+  char encrypt_char(char ch, int shift) {
+    const unsigned char encrypted = ch + shift % 26;
+    if (ch >= 'a' && ch <= 'z') {
+      return encrypted > 'z' ? encrypted - 'z' + 'a' - 1 : encrypted;
+    }
+    return encrypted > 'Z' ? encrypted - 'Z' + 'A' - 1 : encrypted;
+  }
+};
+
+std::string make_text(std::size_t size) {
+  constexpr std::string_view sample { "The quick brown fox, jumps over the lazy dog! " };
+  std::string text;
+  text.reserve(size);
+  while (text.size() < size) {
+    text += sample.substr(0, std::min(sample.size(), size - text.size()));
+  }
+  return text;
+}
+
+template <class Transform>
+void run(benchmark::State &state, Transform transform) {
+  const auto text { make_text(state.range(0)) };
+  std::string output(text.size(), '\0');
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(transform(text, output));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void legacy_per_char(benchmark::State &state) {
+  LegacyCaesar crypto;
+  run(state, [&](auto &&text, auto &&) { return crypto.encrypt(text, 3).size(); });
+}
+
+void kernel_scalar(benchmark::State &state) {
+  const auto kernel { CaesarKernel::for_encryption(3) };
+  run(state, [&](auto &&text, auto &&output) {
+    return kernel.transform_scalar(text.data(), output.data(), text.size());
+  });
+}
+
+#ifdef CRYPTO_X86_KERNELS
+void kernel_sse2(benchmark::State &state) {
+  const auto kernel { CaesarKernel::for_encryption(3) };
+  run(state, [&](auto &&text, auto &&output) {
+    return kernel.transform_sse2(text.data(), output.data(), text.size());
+  });
+}
+
+void kernel_avx2(benchmark::State &state) {
+  if (CpuFeatures::has_avx2() == false) {
+    state.SkipWithError("AVX2 is not supported");
+    return;
+  }
+
+  const auto kernel { CaesarKernel::for_encryption(3) };
+  run(state, [&](auto &&text, auto &&output) {
+    return kernel.transform_avx2(text.data(), output.data(), text.size());
+  });
+}
+#endif
+
+void strategy_encrypt(benchmark::State &state) {
+  CaesarCryptoStrategy crypto;
+  run(state, [&](auto &&text, auto &&) { return crypto.encrypt(text, 3).size(); });
+}
+
+void strategy_encrypt_prepared_key(benchmark::State &state) {
+  CaesarCryptoStrategy crypto;
+  const auto key { crypto.prepare_key("3") };
+  run(state, [&](auto &&text, auto &&) { return crypto.encrypt(text, *key).size(); });
+}
+
+}  // namespace
+
+BENCHMARK(legacy_per_char)->Arg(1 << 20)->Arg(64 << 20);
+BENCHMARK(kernel_scalar)->Arg(1 << 20)->Arg(64 << 20);
+#ifdef CRYPTO_X86_KERNELS
+BENCHMARK(kernel_sse2)->Arg(1 << 20)->Arg(64 << 20);
+BENCHMARK(kernel_avx2)->Arg(1 << 20)->Arg(64 << 20);
+#endif
+BENCHMARK(strategy_encrypt)->Arg(64)->Arg(1 << 20)->Arg(64 << 20);
+BENCHMARK(strategy_encrypt_prepared_key)->Arg(64)->Arg(1 << 20);
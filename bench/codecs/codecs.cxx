@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+#include <cryptopp/base64.h>
+#include <cryptopp/hex.h>
+
+#include "src/text_codec.hpp"
+
+BENCHMARK_MAIN();
+
+namespace {
+
+std::string make_bytes(std::size_t size) {
+  std::string bytes(size, '\0');
+  for (std::size_t i {}; i < size; ++i) {
+    bytes[i] = static_cast<char>(i * 7 + i / 13);
+  }
+  return bytes;
+}
+
+const CryptoPP::byte *to_bytes(const std::string &text) {
+  return reinterpret_cast<const CryptoPP::byte *>(text.data());
+}
+
+template <class Transform>
+void run(benchmark::State &state, const std::string &input, Transform transform) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(transform(input));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+
+// The filters AES used before the codecs, one Put into a StringSink like encode_in_hex and decode_from_hex did.
+template <class Filter>
+std::string put_through(const std::string &input, Filter *filter, std::string &output) {
+  output.clear();
+  filter->Put(to_bytes(input), input.size());
+  filter->MessageEnd();
+  return output;
+}
+
+void cryptopp_hex_encode(benchmark::State &state) {
+  run(state, make_bytes(state.range(0)), [](auto &&bytes) {
+    std::string result;
+    CryptoPP::HexEncoder encoder { new CryptoPP::StringSink { result } };
+    return put_through(bytes, &encoder, result).size();
+  });
+}
+
+void cryptopp_hex_decode(benchmark::State &state) {
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string encoded(2 * bytes.size(), '\0');
+  HexCodec::encode(to_bytes(bytes), bytes.size(), encoded.data());
+
+  run(state, encoded, [](auto &&encoded) {
+    std::string result;
+    CryptoPP::HexDecoder decoder { new CryptoPP::StringSink { result } };
+    return put_through(encoded, &decoder, result).size();
+  });
+}
+
+void cryptopp_base64_encode(benchmark::State &state) {
+  run(state, make_bytes(state.range(0)), [](auto &&bytes) {
+    std::string result;
+    CryptoPP::Base64Encoder encoder { new CryptoPP::StringSink { result }, false };
+    return put_through(bytes, &encoder, result).size();
+  });
+}
+
+void cryptopp_base64_decode(benchmark::State &state) {
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string encoded(Base64Codec::get_encoded_size(bytes.size()), '\0');
+  Base64Codec::encode(to_bytes(bytes), bytes.size(), encoded.data());
+
+  run(state, encoded, [](auto &&encoded) {
+    std::string result;
+    CryptoPP::Base64Decoder decoder { new CryptoPP::StringSink { result } };
+    return put_through(encoded, &decoder, result).size();
+  });
+}
+
+// The codecs write into a buffer sized up front, reused between iterations like the cipher buffers are.
+void encode(benchmark::State &state, TextEncoding encoding) {
+  const TextCodec codec { encoding };
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string result(codec.get_encoded_size(bytes.size()), '\0');
+
+  run(state, bytes, [&](auto &&bytes) {
+    codec.encode(to_bytes(bytes), bytes.size(), result.data());
+    return result.data();
+  });
+}
+
+void decode(benchmark::State &state, TextEncoding encoding) {
+  const TextCodec codec { encoding };
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string encoded(codec.get_encoded_size(bytes.size()), '\0');
+  codec.encode(to_bytes(bytes), bytes.size(), encoded.data());
+  std::vector<std::uint8_t> result(codec.get_max_decoded_size(encoded.size()));
+
+  run(state, encoded, [&](auto &&encoded) { return codec.decode(encoded.data(), encoded.size(), result.data()); });
+}
+
+// The scalar tails of the codecs on their own, to show what the vector kernels add.
+void hex_encode_scalar(benchmark::State &state) {
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string result(2 * bytes.size(), '\0');
+
+  run(state, bytes, [&](auto &&bytes) {
+    HexCodec::encode_scalar(to_bytes(bytes), bytes.size(), result.data());
+    return result.data();
+  });
+}
+
+void base64_encode_scalar(benchmark::State &state) {
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string result(Base64Codec::get_encoded_size(bytes.size()), '\0');
+
+  run(state, bytes, [&](auto &&bytes) {
+    Base64Codec::encode_scalar(to_bytes(bytes), bytes.size(), result.data());
+    return result.data();
+  });
+}
+
+void base64_decode_scalar(benchmark::State &state) {
+  const auto bytes { make_bytes(state.range(0)) };
+  std::string encoded(Base64Codec::get_encoded_size(bytes.size()), '\0');
+  Base64Codec::encode(to_bytes(bytes), bytes.size(), encoded.data());
+  std::vector<std::uint8_t> result(bytes.size());
+
+  run(state, encoded, [&](auto &&encoded) {
+    return Base64Codec::decode_scalar(encoded.data(), encoded.size(), result.data());
+  });
+}
+
+void apply_sizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(64)->Range(64, 1 << 24)->Unit(benchmark::kMicrosecond);
+}
+
+}  // namespace
+
+BENCHMARK(cryptopp_hex_encode)->Apply(apply_sizes);
+BENCHMARK(hex_encode_scalar)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encode, hex, TextEncoding::HEX)->Apply(apply_sizes);
+BENCHMARK(cryptopp_hex_decode)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decode, hex, TextEncoding::HEX)->Apply(apply_sizes);
+
+BENCHMARK(cryptopp_base64_encode)->Apply(apply_sizes);
+BENCHMARK(base64_encode_scalar)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encode, base64, TextEncoding::BASE64)->Apply(apply_sizes);
+BENCHMARK(cryptopp_base64_decode)->Apply(apply_sizes);
+BENCHMARK(base64_decode_scalar)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decode, base64, TextEncoding::BASE64)->Apply(apply_sizes);
+
+BENCHMARK_CAPTURE(encode, raw, TextEncoding::RAW)->Apply(apply_sizes);
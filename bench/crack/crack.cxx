@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <limits>
+
+#include "src/caesar_cracker.hpp"
+#include "src/vigenere_cracker.hpp"
+
+BENCHMARK_MAIN();
+
+namespace {
+
+std::string make_text(std::size_t size) {
+  constexpr std::string_view sample {
+    "the river ran slowly through the old town, past the mill and the market, where the traders of the valley had "
+    "met every week for as long as anyone could remember. in the morning the square was full of carts and voices; "
+    "by evening only the swallows were left, circling above the roofs while the last light faded behind the hills. "
+  };
+  std::string text;
+  text.reserve(size);
+  while (text.size() < size) {
+    text += sample.substr(0, std::min(sample.size(), size - text.size()));
+  }
+  return text;
+}
+
+template <class Process>
+void run(benchmark::State &state, const std::string &text, Process process) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process(text));
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+template <class Process>
+void run_vigenere(benchmark::State &state, Process process) {
+  run(state, VigenereCryptoStrategy {}.encrypt(make_text(state.range(0)), std::any { "lemonadestand" }), process);
+}
+
+template <class Process>
+void run_caesar(benchmark::State &state, Process process) {
+  run(state, CaesarCryptoStrategy {}.encrypt(make_text(state.range(0)), 11), process);
+}
+
+void letter_histogram_scalar(benchmark::State &state) {
+  run_vigenere(state, [](auto &&text) {
+    LetterHistogram::Counts counts {};
+    LetterHistogram::count_scalar(text, counts);
+    return counts[0];
+  });
+}
+
+void letter_histogram(benchmark::State &state) {
+  run_vigenere(state, [](auto &&text) { return LetterHistogram::count(text)[0]; });
+}
+
+void coincidences_scalar(benchmark::State &state) {
+  run_vigenere(state, [](auto &&text) { return VigenereCracker::count_coincidences_scalar(text, 13); });
+}
+
+void coincidences(benchmark::State &state) {
+  run_vigenere(state, [](auto &&text) { return VigenereCracker::count_coincidences(text, 13); });
+}
+
+void vigenere_crack(benchmark::State &state) {
+  const VigenereCracker cracker { static_cast<unsigned>(state.range(1)) };
+  run_vigenere(state, [&](auto &&text) { return cracker.crack(text).key.size(); });
+}
+
+// What the ranking replaces: every shift decrypted through the strategy and the result compared with English.
+void caesar_decrypt_every_shift(benchmark::State &state) {
+  CaesarCryptoStrategy strategy;
+  run_caesar(state, [&](auto &&text) {
+    auto best_shift { 0 };
+    auto best_chi_squared { std::numeric_limits<double>::max() };
+    for (auto shift { 0 }; shift < 26; ++shift) {
+      const auto chi_squared { LetterHistogram::chi_squared(LetterHistogram::count(strategy.decrypt(text, shift)), 0) };
+      if (chi_squared < best_chi_squared) {
+        best_shift = shift;
+        best_chi_squared = chi_squared;
+      }
+    }
+    return best_shift;
+  });
+}
+
+void caesar_rank(benchmark::State &state) {
+  run_caesar(state, [](auto &&text) { return CaesarCracker::rank(text)[0].shift; });
+}
+
+void caesar_crack(benchmark::State &state) {
+  run_caesar(state, [](auto &&text) { return CaesarCracker::crack(text).plain_text.size(); });
+}
+
+}  // namespace
+
+BENCHMARK(letter_histogram_scalar)->Arg(1 << 20);
+BENCHMARK(letter_histogram)->Arg(1 << 20);
+BENCHMARK(coincidences_scalar)->Arg(1 << 20);
+BENCHMARK(coincidences)->Arg(1 << 20);
+BENCHMARK(vigenere_crack)
+    ->Args({ 1 << 20, 1 })
+    ->Args({ 1 << 20, 4 })
+    ->Args({ 16 << 20, 4 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(caesar_decrypt_every_shift)->Arg(1 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(caesar_rank)->Arg(1 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(caesar_crack)->Arg(1 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
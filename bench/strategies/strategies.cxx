@@ -0,0 +1,252 @@
+#include <benchmark/benchmark.h>
+
+#include "bench/allocation_counter.hpp"
+#include "src/batch_crypto.hpp"
+#include "src/crypto_strategies_factory.hpp"
+#include "src/input.hpp"
+
+BENCHMARK_MAIN();
+
+namespace {
+
+constexpr const char *caesar_key { "3" };
+constexpr const char *vigenere_key { "lemon" };
+constexpr const char *aes_key { "hellohellohelloh" };
+constexpr const char *cascade_key { "vigenere:lemon|caesar:3|aes:hellohellohelloh" };
+
+// Lower case letters, spaces and punctuation, valid for every strategy.
+std::string make_text(std::size_t size) {
+  constexpr std::string_view sample { "the quick brown fox, jumps over the lazy dog! " };
+  std::string text;
+  text.reserve(size);
+  while (text.size() < size) {
+    text += sample.substr(0, std::min(sample.size(), size - text.size()));
+  }
+  return text;
+}
+
+template <class Transform>
+void run(benchmark::State &state, const std::string &text, Transform transform) {
+  const auto allocations { AllocationCounter::get() };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(transform(text));
+    benchmark::ClobberMemory();
+  }
+
+  AllocationCounter::report(state, allocations);
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void encrypt(benchmark::State &state, std::string_view name, const char *key) {
+  auto crypto_strategies { make_crypto_strategies() };
+  auto &strategy { *crypto_strategies.at(name) };
+  const auto any { strategy.is_key_numeric() ? std::any { std::stoi(key) } : std::any { key } };
+
+  run(state, make_text(state.range(0)), [&](auto &&text) { return strategy.encrypt(text, any).size(); });
+}
+
+void decrypt(benchmark::State &state, std::string_view name, const char *key) {
+  auto crypto_strategies { make_crypto_strategies() };
+  auto &strategy { *crypto_strategies.at(name) };
+  const auto any { strategy.is_key_numeric() ? std::any { std::stoi(key) } : std::any { key } };
+  const auto encrypted { strategy.encrypt(make_text(state.range(0)), any) };
+
+  run(state, encrypted, [&](auto &&text) { return strategy.decrypt(text, any).size(); });
+}
+
+// The same work through a prepared key and a reused output buffer.
+void encrypt_into(benchmark::State &state, std::string_view name, const char *key) {
+  auto crypto_strategies { make_crypto_strategies() };
+  auto &strategy { *crypto_strategies.at(name) };
+  const auto prepared_key { strategy.prepare_key(key) };
+  const auto text { make_text(state.range(0)) };
+  std::vector<std::byte> output(strategy.max_encrypted_size(text.size()));
+
+  run(state, text, [&](auto &&text) {
+    return strategy.encrypt_into(std::as_bytes(std::span { text }), output, *prepared_key);
+  });
+}
+
+// The GUI and CLI path: strategy lookup, key parsing and the copy into the data view.
+void input_encrypt(benchmark::State &state, std::string_view name, const char *key) {
+  DataView data_view;
+  CryptoInput input { data_view, make_crypto_strategies() };
+
+  run(state, make_text(state.range(0)), [&](auto &&text) {
+    input.encrypt(name, text, key);
+    return data_view.output_text.size();
+  });
+}
+
+// The chain a cascade replaces: a CryptoInput round trip and a full string per stage, each stage reading the whole
+// output of the one before.
+void input_chain_encrypt(benchmark::State &state) {
+  DataView data_view;
+  CryptoInput input { data_view, make_crypto_strategies() };
+  constexpr std::array<std::pair<std::string_view, const char *>, 3> stages {
+    { { "vigenere", vigenere_key }, { "caesar", caesar_key }, { "aes", aes_key } }
+  };
+
+  run(state, make_text(state.range(0)), [&](auto &&text) {
+    input.encrypt(stages[0].first, text, stages[0].second);
+    for (auto &&[name, key] : std::span { stages }.subspan(1)) {
+      const auto stage_text { std::move(data_view.output_text) };
+      input.encrypt(name, stage_text, key);
+    }
+    return data_view.output_text.size();
+  });
+}
+
+// Many small records of record_size bytes: through the batch API, and one by one through CryptoInput for comparison.
+constexpr std::size_t record_size { 300 };
+
+RecordBatch make_records(std::size_t count) {
+  RecordBatch records;
+  const auto text { make_text(record_size) };
+  for (std::size_t i {}; i < count; ++i) {
+    records.push_back(text);
+  }
+  return records;
+}
+
+void batch_encrypt(benchmark::State &state, std::string_view name, const char *key) {
+  auto crypto_strategies { make_crypto_strategies() };
+  BatchCrypto batch { *crypto_strategies.at(name) };
+  const auto records { make_records(state.range(0)) };
+
+  run(state, records.data, [&](auto &&) { return batch.encrypt(records, key).records.data.size(); });
+}
+
+void records_input_encrypt(benchmark::State &state, std::string_view name, const char *key) {
+  DataView data_view;
+  CryptoInput input { data_view, make_crypto_strategies() };
+  const auto records { make_records(state.range(0)) };
+
+  run(state, records.data, [&](auto &&) {
+    std::size_t size {};
+    for (std::size_t i {}; i < records.size(); ++i) {
+      input.encrypt(name, std::string { records[i] }, key);
+      size += data_view.output_text.size();
+    }
+    return size;
+  });
+}
+
+// Every fifth record has a digit, which no strategy but AES accepts: the throwing API unwinds for each of them.
+RecordBatch make_dirty_records(std::size_t count) {
+  RecordBatch records;
+  auto text { make_text(record_size) };
+  for (std::size_t i {}; i < count; ++i) {
+    text[record_size / 2] = i % 5 == 0 ? '7' : 'a';
+    records.push_back(text);
+  }
+  return records;
+}
+
+template <class Process>
+void run_dirty(benchmark::State &state, std::string_view name, const char *key, Process process) {
+  auto crypto_strategies { make_crypto_strategies() };
+  auto &strategy { *crypto_strategies.at(name) };
+  const auto prepared_key { strategy.prepare_key(key) };
+  const auto records { make_dirty_records(state.range(0)) };
+  std::vector<std::byte> output(strategy.max_encrypted_size(record_size));
+
+  for (auto _ : state) {
+    std::size_t errors {};
+    for (std::size_t i {}; i < records.size(); ++i) {
+      errors += process(strategy, std::as_bytes(std::span { records[i] }), std::span { output }, *prepared_key);
+    }
+    benchmark::DoNotOptimize(errors);
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(records.data.size()));
+}
+
+void dirty_encrypt_into(benchmark::State &state, std::string_view name, const char *key) {
+  run_dirty(state, name, key, [](auto &strategy, auto in, auto out, auto &prepared_key) {
+    try {
+      strategy.encrypt_into(in, out, prepared_key);
+      return false;
+    } catch (const std::exception &) {
+      return true;
+    }
+  });
+}
+
+void dirty_try_encrypt_into(benchmark::State &state, std::string_view name, const char *key) {
+  run_dirty(state, name, key, [](auto &strategy, auto in, auto out, auto &prepared_key) {
+    return strategy.try_encrypt_into(in, out, prepared_key).has_value() == false;
+  });
+}
+
+// Concurrent callers with an input each over one shared registry, the throughput should scale with the threads.
+void shared_input_encrypt(benchmark::State &state, std::string_view name, const char *key) {
+  static const auto crypto_strategies { make_shared_crypto_strategies() };
+  DataView data_view;
+  CryptoInput input { data_view, crypto_strategies };
+  const auto text { make_text(record_size) };
+
+  for (auto _ : state) {
+    input.encrypt(name, text, key);
+    benchmark::DoNotOptimize(data_view.output_text.size());
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void apply_threads(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ThreadRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))->UseRealTime();
+}
+
+void apply_records_counts(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(16)->Range(1 << 8, 1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void apply_sizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(64)->Range(16, 1 << 30)->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(encrypt, caesar, "caesar", caesar_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decrypt, caesar, "caesar", caesar_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encrypt_into, caesar, "caesar", caesar_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(input_encrypt, caesar, "caesar", caesar_key)->Apply(apply_sizes);
+
+BENCHMARK_CAPTURE(encrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encrypt_into, vigenere, "vigenere", vigenere_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(input_encrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_sizes);
+
+BENCHMARK_CAPTURE(encrypt, aes, "aes", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decrypt, aes, "aes", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encrypt_into, aes, "aes", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(input_encrypt, aes, "aes", aes_key)->Apply(apply_sizes);
+
+BENCHMARK_CAPTURE(encrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(decrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encrypt_into, aes_ctr, "aes-ctr", aes_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(input_encrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_sizes);
+
+BENCHMARK(input_chain_encrypt)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(input_encrypt, cascade, "cascade", cascade_key)->Apply(apply_sizes);
+BENCHMARK_CAPTURE(encrypt_into, cascade, "cascade", cascade_key)->Apply(apply_sizes);
+
+BENCHMARK_CAPTURE(batch_encrypt, caesar, "caesar", caesar_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(records_input_encrypt, caesar, "caesar", caesar_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(batch_encrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(records_input_encrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(batch_encrypt, aes, "aes", aes_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(records_input_encrypt, aes, "aes", aes_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(batch_encrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_records_counts);
+BENCHMARK_CAPTURE(records_input_encrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_records_counts);
+
+BENCHMARK_CAPTURE(shared_input_encrypt, caesar, "caesar", caesar_key)->Apply(apply_threads);
+BENCHMARK_CAPTURE(shared_input_encrypt, vigenere, "vigenere", vigenere_key)->Apply(apply_threads);
+BENCHMARK_CAPTURE(shared_input_encrypt, aes, "aes", aes_key)->Apply(apply_threads);
+BENCHMARK_CAPTURE(shared_input_encrypt, aes_ctr, "aes-ctr", aes_key)->Apply(apply_threads);
+
+BENCHMARK_CAPTURE(dirty_encrypt_into, caesar, "caesar", caesar_key)->Arg(1 << 14);
+BENCHMARK_CAPTURE(dirty_try_encrypt_into, caesar, "caesar", caesar_key)->Arg(1 << 14);
+BENCHMARK_CAPTURE(dirty_encrypt_into, vigenere, "vigenere", vigenere_key)->Arg(1 << 14);
+BENCHMARK_CAPTURE(dirty_try_encrypt_into, vigenere, "vigenere", vigenere_key)->Arg(1 << 14);
@@ -0,0 +1,315 @@
+#ifndef AES_BATCH_CRYPTO_HPP
+#define AES_BATCH_CRYPTO_HPP
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "aes_crypto.hpp"
+#include "aes_multi_buffer.hpp"
+#include "batch_crypto.hpp"
+#include "text_codec.hpp"
+
+// Encrypts many short records like AESCryptoStrategy does, ECB with PKCS #7 padding written in the given encoding, but
+// feeds the blocks of all records of a task through AESMultiBuffer together instead of one record at a time. The keys
+// are either one for the whole batch or one per record. Without AES-NI every record goes through
+// AESCryptoStrategy instead, with the same results.
+class AESBatchCrypto {
+ public:
+  static constexpr std::size_t records_per_task { 256 };
+
+  explicit AESBatchCrypto(TextEncoding encoding = TextEncoding::HEX,
+                          unsigned threads = std::thread::hardware_concurrency())
+      : codec { encoding }, fallback { encoding }, pool { threads } {}
+
+  // Throws when the key itself is invalid, since then no record could succeed.
+  BatchResult encrypt(const RecordBatch &records, const char *key) { return process(records, key, true); }
+
+  BatchResult decrypt(const RecordBatch &records, const char *key) { return process(records, key, false); }
+
+  // Key i is of record i. A record with an invalid key fails alone, with invalid_key_length_error.
+  BatchResult encrypt(const RecordBatch &records, std::span<const char *const> keys) {
+    return process(records, keys, true);
+  }
+
+  BatchResult decrypt(const RecordBatch &records, std::span<const char *const> keys) {
+    return process(records, keys, false);
+  }
+
+ private:
+  static constexpr std::size_t block_size { AESRoundKeys::block_size };
+
+  // The expanded keys of a batch, each distinct key once. A null key is one that failed to expand. They are expanded
+  // even for the fallback, which then only needs them to tell the invalid keys.
+  struct Keys {
+    std::unordered_map<std::string_view, std::optional<AESRoundKeys>> expanded;
+    std::vector<const AESRoundKeys *> of_records;
+    const AESRoundKeys *shared {};
+  };
+
+  // Per worker, reused from task to task. The jobs are split by key length, one call of AESMultiBuffer takes one.
+  struct Scratch {
+    std::vector<std::uint8_t> ciphertext;
+    std::array<std::vector<AESMessageJob>, 3> jobs;
+    std::unordered_map<std::string_view, std::unique_ptr<PreparedKey>> fallback_keys;
+  };
+
+  BatchResult process(const RecordBatch &records, const char *key, bool is_encryption) {
+    Keys keys;
+    keys.shared = &keys.expanded.try_emplace(key, AESRoundKeys { key }).first->second.value();
+    return process(records, keys, [key](std::size_t) { return key; }, is_encryption);
+  }
+
+  BatchResult process(const RecordBatch &records, std::span<const char *const> record_keys, bool is_encryption) {
+    if (record_keys.size() != records.size()) {
+      throw_exception(wrong_keys_count_error);
+    }
+
+    Keys keys;
+    for (auto &&key : record_keys) {
+      const auto [it, is_new] { keys.expanded.try_emplace(key) };
+      if (is_new) {
+        it->second = expand(key);
+      }
+      keys.of_records.push_back(it->second.has_value() ? &*it->second : nullptr);
+    }
+    return process(records, keys, [record_keys](std::size_t index) { return record_keys[index]; }, is_encryption);
+  }
+
+  template <class KeyOf>
+  BatchResult process(const RecordBatch &records, const Keys &keys, KeyOf key_of, bool is_encryption) {
+    BatchResult result;
+    auto &offsets { result.records.offsets };
+    offsets.resize(records.size() + 1);
+    for (std::size_t index {}; index < records.size(); ++index) {
+      const auto size { records[index].size() };
+      offsets[index + 1] =
+          offsets[index] + (is_encryption ? get_encrypted_size(size) : codec.get_max_decoded_size(size));
+    }
+    result.records.data.resize(offsets.back());
+    result.errors.assign(records.size(), nullptr);
+
+    std::vector<std::size_t> sizes(records.size());
+    std::vector<Scratch> scratches(pool.get_threads_count());
+    const auto tasks_count { (records.size() + records_per_task - 1) / records_per_task };
+    pool.run(tasks_count, [&](std::size_t task, unsigned worker) {
+      const auto begin { task * records_per_task };
+      const auto end { std::min(records.size(), begin + records_per_task) };
+      Task current { records, result, sizes, begin, end, scratches[worker] };
+      if (AESMultiBuffer::is_supported() == false) {
+        process_with_fallback(current, keys, key_of, is_encryption);
+      } else if (is_encryption) {
+        encrypt_records(current, keys);
+      } else {
+        decrypt_records(current, keys);
+      }
+    });
+
+    result.records.compact(sizes);
+    return result;
+  }
+
+  struct Task {
+    const RecordBatch &records;
+    BatchResult &result;
+    std::vector<std::size_t> &sizes;
+    std::size_t begin;
+    std::size_t end;
+    Scratch &scratch;
+
+    std::uint8_t *get_output(std::size_t index) const noexcept {
+      return reinterpret_cast<std::uint8_t *>(result.records.data.data() + result.records.offsets[index]);
+    }
+
+    static const std::uint8_t *get_input(std::string_view record) noexcept {
+      return reinterpret_cast<const std::uint8_t *>(record.data());
+    }
+  };
+
+  // Pads every record into its ciphertext slot, raw output goes straight into the result. All blocks of the task are
+  // encrypted before anything is encoded.
+  void encrypt_records(Task &task, const Keys &keys) const noexcept {
+    auto &[records, result, sizes, begin, end, scratch] { task };
+    const auto is_raw { codec.get_encoding() == TextEncoding::RAW };
+    clear_jobs(scratch);
+    std::size_t ciphertext_size {};
+    for (auto index { begin }; index < end; ++index) {
+      ciphertext_size += get_padded_size(records[index].size());
+    }
+    scratch.ciphertext.resize(is_raw ? 0 : ciphertext_size);
+
+    std::size_t ciphertext_offset {};
+    for (auto index { begin }; index < end; ++index) {
+      const auto *round_keys { get_keys(keys, index) };
+      if (round_keys == nullptr) {
+        result.errors[index] = invalid_key_length_error;
+        continue;
+      }
+
+      const auto record { records[index] };
+      auto *ciphertext { is_raw ? task.get_output(index) : scratch.ciphertext.data() + ciphertext_offset };
+      ciphertext_offset += get_padded_size(record.size());
+      // The whole blocks are read straight from the record, only the padded last one is put together. PKCS #7, as in
+      // CryptoLibAESImplementation.
+      const auto whole_blocks_count { record.size() / block_size };
+      const auto rest { record.size() % block_size };
+      auto *last_block { ciphertext + whole_blocks_count * block_size };
+      std::copy_n(Task::get_input(record) + whole_blocks_count * block_size, rest, last_block);
+      std::fill(last_block + rest, last_block + block_size, static_cast<std::uint8_t>(block_size - rest));
+      auto &jobs { get_jobs(scratch, *round_keys) };
+      jobs.push_back({ Task::get_input(record), ciphertext, whole_blocks_count, round_keys });
+      jobs.push_back({ last_block, last_block, 1, round_keys });
+    }
+
+    run_jobs(scratch, keys, true);
+
+    ciphertext_offset = 0;
+    for (auto index { begin }; index < end; ++index) {
+      if (result.errors[index] != nullptr) {
+        continue;
+      }
+
+      const auto padded_size { get_padded_size(records[index].size()) };
+      if (is_raw == false) {
+        codec.encode(scratch.ciphertext.data() + ciphertext_offset, padded_size,
+                     reinterpret_cast<char *>(task.get_output(index)));
+        ciphertext_offset += padded_size;
+      }
+      sizes[index] = codec.get_encoded_size(padded_size);
+    }
+  }
+
+  // Decodes every record straight into its output slot and decrypts it there, raw records are read in place.
+  void decrypt_records(Task &task, const Keys &keys) const noexcept {
+    auto &[records, result, sizes, begin, end, scratch] { task };
+    const auto is_raw { codec.get_encoding() == TextEncoding::RAW };
+    clear_jobs(scratch);
+
+    for (auto index { begin }; index < end; ++index) {
+      const auto *round_keys { get_keys(keys, index) };
+      if (round_keys == nullptr) {
+        result.errors[index] = invalid_key_length_error;
+        continue;
+      }
+
+      const auto record { records[index] };
+      auto *decrypted { task.get_output(index) };
+      const auto size { is_raw ? std::optional { record.size() }
+                               : codec.decode(record.data(), record.size(), decrypted) };
+      if (size.has_value() == false || *size == 0 || *size % block_size != 0) {
+        result.errors[index] = broken_ciphertext_error;
+        continue;
+      }
+
+      const auto *ciphertext { is_raw ? Task::get_input(record) : decrypted };
+      get_jobs(scratch, *round_keys).push_back({ ciphertext, decrypted, *size / block_size, round_keys });
+      sizes[index] = *size;
+    }
+
+    run_jobs(scratch, keys, false);
+
+    for (auto index { begin }; index < end; ++index) {
+      if (result.errors[index] != nullptr) {
+        continue;
+      }
+
+      const auto *decrypted { task.get_output(index) };
+      const auto size { sizes[index] };
+      const auto padding { decrypted[size - 1] };
+      if (padding == 0 || padding > block_size ||
+          std::any_of(decrypted + size - padding, decrypted + size, [padding](auto ch) { return ch != padding; })) {
+        result.errors[index] = broken_ciphertext_error;
+        sizes[index] = 0;
+        continue;
+      }
+      sizes[index] = size - padding;
+    }
+  }
+
+  template <class KeyOf>
+  void process_with_fallback(Task &task, const Keys &keys, KeyOf key_of, bool is_encryption) noexcept {
+    auto &[records, result, sizes, begin, end, scratch] { task };
+    for (auto index { begin }; index < end; ++index) {
+      const auto *prepared_key { get_keys(keys, index) != nullptr ? get_fallback_key(scratch, key_of(index))
+                                                                  : nullptr };
+      if (prepared_key == nullptr) {
+        result.errors[index] = invalid_key_length_error;
+        continue;
+      }
+
+      const auto in { std::as_bytes(std::span { records[index] }) };
+      const std::span out { reinterpret_cast<std::byte *>(task.get_output(index)),
+                            result.records.offsets[index + 1] - result.records.offsets[index] };
+      const auto size { is_encryption ? fallback.try_encrypt_into(in, out, *prepared_key)
+                                      : fallback.try_decrypt_into(in, out, *prepared_key) };
+      if (size.has_value() == false) {
+        result.errors[index] = size.error();
+        continue;
+      }
+      sizes[index] = *size;
+    }
+  }
+
+  // Prepared keys hold cipher state, so every worker keeps its own. Null when preparing fails.
+  const PreparedKey *get_fallback_key(Scratch &scratch, const char *key) noexcept {
+    const auto [it, is_new] { scratch.fallback_keys.try_emplace(key) };
+    if (is_new) {
+      try {
+        it->second = fallback.prepare_key(key);
+      } catch (...) {
+        scratch.fallback_keys.erase(it);
+        return nullptr;
+      }
+    }
+    return it->second.get();
+  }
+
+  static std::optional<AESRoundKeys> expand(std::string_view key) noexcept {
+    try {
+      return AESRoundKeys { key };
+    } catch (const CryptoError &) {
+      return std::nullopt;
+    }
+  }
+
+  static const AESRoundKeys *get_keys(const Keys &keys, std::size_t index) noexcept {
+    return keys.shared != nullptr ? keys.shared : keys.of_records[index];
+  }
+
+  static std::vector<AESMessageJob> &get_jobs(Scratch &scratch, const AESRoundKeys &keys) noexcept {
+    return scratch.jobs[(keys.rounds_count - 10) / 2];
+  }
+
+  static void clear_jobs(Scratch &scratch) noexcept {
+    for (auto &&jobs : scratch.jobs) {
+      jobs.clear();
+    }
+  }
+
+  static void run_jobs(Scratch &scratch, const Keys &keys, bool is_encryption) noexcept {
+    for (auto &&jobs : scratch.jobs) {
+      if (is_encryption) {
+        AESMultiBuffer::encrypt(jobs, keys.shared);
+      } else {
+        AESMultiBuffer::decrypt(jobs, keys.shared);
+      }
+    }
+  }
+
+  static std::size_t get_padded_size(std::size_t size) noexcept { return (size / block_size + 1) * block_size; }
+
+  std::size_t get_encrypted_size(std::size_t size) const noexcept {
+    return codec.get_encoded_size(get_padded_size(size));
+  }
+
+  TextCodec codec;
+  AESCryptoStrategy fallback;
+  WorkStealingPool pool;
+};
+
+#endif
@@ -3,78 +3,381 @@
 
 #include <cryptopp/cryptlib.h>
 #include <cryptopp/files.h>
-#include <cryptopp/hex.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/osrng.h>
 #include <cryptopp/rijndael.h>
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+
 #include "crypto_strategy.hpp"
+#include "errors.hpp"
+#include "key_schedule_cache.hpp"
+#include "text_codec.hpp"
+#include "trace.hpp"
 
 class Utility {
  public:
   static const CryptoPP::byte *cast_to_byte(const std::string &text) {
     return reinterpret_cast<const CryptoPP::byte *>(&text[0]);
   }
+
+  static CryptoPP::byte *cast_to_byte(std::string &text) { return reinterpret_cast<CryptoPP::byte *>(&text[0]); }
 };
 
 class AESImplementation {
  public:
+  virtual ~AESImplementation() = default;
+
   virtual std::string encrypt(const std::string &text_for_encoding, const std::string &key) = 0;
 
   virtual std::string decrypt(const std::string &text_for_encoding, const std::string &key) = 0;
+
+  virtual std::unique_ptr<PreparedKey> prepare_key(const std::string &key) = 0;
+
+  virtual std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) = 0;
+
+  virtual std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) = 0;
+
+  // The output is sized by the caller from max_encrypted_size / max_decrypted_size.
+  virtual std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) = 0;
+
+  virtual SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                                       const PreparedKey &key) noexcept = 0;
+
+  virtual std::unique_ptr<CryptoStream> create_encryption_stream() = 0;
+
+  virtual std::unique_ptr<CryptoStream> create_decryption_stream() = 0;
+
+  virtual std::size_t max_encrypted_size(std::size_t text_size) noexcept = 0;
+
+  virtual std::size_t max_decrypted_size(std::size_t text_size) noexcept = 0;
 };
 
-class CryptoLibAESImplementation : public AESImplementation {
+// Partial blocks stay buffered inside the filter chain between updates, the padding block is flushed on finish.
+class CryptoLibAESStream : public CryptoStream {
  public:
-  std::string encrypt(const std::string &text_for_encoding, const std::string &key) override {
-    encryptor.SetKey(Utility::cast_to_byte(key), key.size());
-
-    const auto encoded { encrypt_string(text_for_encoding) };
-    return encode_in_hex(encoded);
+  void begin(const std::any &any) override {
+    output.clear();
+    pipeline.reset(create_pipeline(std::any_cast<const char *>(any)));
   }
 
-  std::string decrypt(const std::string &text_for_decoding, const std::string &key) override {
-    decryptor.SetKey(Utility::cast_to_byte(key), key.size());
+  std::string update(const std::string &chunk) override {
+    pipeline->Put(Utility::cast_to_byte(chunk), chunk.size());
+    return take_output();
+  }
 
-    const auto decoded_from_hex { decode_from_hex(text_for_decoding) };
-    return decrypt_string(decoded_from_hex);
+  std::string finish() override {
+    pipeline->MessageEnd();
+    return take_output();
   }
 
+ protected:
+  virtual CryptoPP::BufferedTransformation *create_pipeline(const std::string &key) = 0;
+
+  std::string output;
+
  private:
-  std::string encrypt_string(const std::string &text_for_encoding) {
+  std::string take_output() {
     std::string result;
-    const auto filter { new CryptoPP::StreamTransformationFilter { encryptor, new CryptoPP::StringSink { result } } };
-    const CryptoPP::StringSource s { text_for_encoding, true, filter };
+    result.swap(output);
     return result;
   }
 
-  std::string encode_in_hex(const std::string &decoded) {
-    std::string result;
-    CryptoPP::HexEncoder encoder { new CryptoPP::StringSink { result } };
-    encoder.Put(Utility::cast_to_byte(decoded), decoded.size());
-    encoder.MessageEnd();
+  std::unique_ptr<CryptoPP::BufferedTransformation> pipeline;
+};
+
+// The ciphertext is encoded after the filter chain, whole groups at a time, the rest waits for the next update.
+class CryptoLibAESEncryptionStream : public CryptoLibAESStream {
+ public:
+  explicit CryptoLibAESEncryptionStream(TextEncoding encoding = TextEncoding::HEX) : codec { encoding } {}
+
+  void begin(const std::any &any) override {
+    pending.clear();
+    CryptoLibAESStream::begin(any);
+  }
+
+  std::string update(const std::string &chunk) override { return encode(CryptoLibAESStream::update(chunk), false); }
+
+  std::string finish() override { return encode(CryptoLibAESStream::finish(), true); }
+
+ private:
+  CryptoPP::BufferedTransformation *create_pipeline(const std::string &key) override {
+    encryptor.SetKey(Utility::cast_to_byte(key), key.size());
+    return new CryptoPP::StreamTransformationFilter { encryptor, new CryptoPP::StringSink { output } };
+  }
+
+  std::string encode(const std::string &ciphertext, bool is_last) {
+    pending += ciphertext;
+    const auto group_size { codec.get_group_size() };
+    const auto size { is_last ? pending.size() : pending.size() / group_size * group_size };
+
+    std::string result(codec.get_encoded_size(size), '\0');
+    codec.encode(Utility::cast_to_byte(pending), size, result.data());
+    pending.erase(0, size);
     return result;
   }
 
-  std::string decode_from_hex(const std::string &encoded) {
-    std::string result;
-    CryptoPP::HexDecoder decoder { new CryptoPP::StringSink { result } };
-    decoder.Put(Utility::cast_to_byte(encoded), encoded.size());
-    decoder.MessageEnd();
+  TextCodec codec;
+  std::string pending;
+  CryptoPP::ECB_Mode<CryptoPP::AES>::Encryption encryptor;
+};
+
+// The text is decoded before the filter chain, whole groups at a time. The last char is held back until finish, so
+// Base64 padding is only accepted at the very end.
+class CryptoLibAESDecryptionStream : public CryptoLibAESStream {
+ public:
+  explicit CryptoLibAESDecryptionStream(TextEncoding encoding = TextEncoding::HEX) : codec { encoding } {}
+
+  void begin(const std::any &any) override {
+    pending.clear();
+    CryptoLibAESStream::begin(any);
+  }
+
+  std::string update(const std::string &chunk) override { return CryptoLibAESStream::update(decode(chunk, false)); }
+
+  std::string finish() override {
+    auto result { CryptoLibAESStream::update(decode({}, true)) };
+    result += CryptoLibAESStream::finish();
     return result;
   }
 
-  std::string decrypt_string(const std::string &text_for_decoding) {
-    std::string result;
-    const auto filter { new CryptoPP::StreamTransformationFilter { decryptor, new CryptoPP::StringSink { result } } };
-    const CryptoPP::StringSource s { text_for_decoding, true, filter };
+ private:
+  CryptoPP::BufferedTransformation *create_pipeline(const std::string &key) override {
+    decryptor.SetKey(Utility::cast_to_byte(key), key.size());
+    return new CryptoPP::StreamTransformationFilter { decryptor, new CryptoPP::StringSink { output } };
+  }
+
+  std::string decode(const std::string &chunk, bool is_last) {
+    pending += chunk;
+    const auto group_size { codec.get_encoded_group_size() };
+    const auto ready { is_last ? pending.size() : pending.size() - std::min<std::size_t>(pending.size(), 1) };
+    const auto size { is_last ? ready : ready / group_size * group_size };
+
+    std::string result(codec.get_max_decoded_size(size), '\0');
+    const auto decoded_size { codec.decode(pending.data(), size, Utility::cast_to_byte(result)) };
+    if (decoded_size.has_value() == false || (is_last == false && *decoded_size != result.size())) {
+      throw_exception(broken_ciphertext_error);
+    }
+
+    result.resize(*decoded_size);
+    pending.erase(0, size);
     return result;
   }
 
-  CryptoPP::ECB_Mode<CryptoPP::AES>::Encryption encryptor;
+  TextCodec codec;
+  std::string pending;
   CryptoPP::ECB_Mode<CryptoPP::AES>::Decryption decryptor;
 };
 
+// The expanded schedules are driven through external-cipher modes, so one prepared key serves any number of calls.
+class CryptoLibAESKey : public PreparedKey {
+ public:
+  explicit CryptoLibAESKey(const std::string &key) {
+    encryption.SetKey(Utility::cast_to_byte(key), key.size());
+    decryption.SetKey(Utility::cast_to_byte(key), key.size());
+  }
+
+  mutable CryptoPP::AES::Encryption encryption;
+  mutable CryptoPP::AES::Decryption decryption;
+};
+
+// Safe to share between threads. The caches hold only expanded key schedules, a call copies its schedule out under the
+// lock and runs the cipher on that copy, so concurrent calls never touch the same cipher state. The ciphertext is
+// written as text in the encoding given at construction, hex by default.
+class CryptoLibAESImplementation : public AESImplementation {
+ public:
+  using Encryptor = CryptoPP::AES::Encryption;
+  using Decryptor = CryptoPP::AES::Decryption;
+
+  static constexpr std::size_t default_key_cache_capacity { 16 };
+
+  explicit CryptoLibAESImplementation(std::size_t key_cache_capacity = default_key_cache_capacity,
+                                      TextEncoding encoding = TextEncoding::HEX)
+      : codec { encoding }, encryptors { key_cache_capacity }, decryptors { key_cache_capacity } {}
+
+  std::string encrypt(const std::string &text_for_encoding, const std::string &key) override {
+    auto schedule { get_encryptor(key) };
+    CryptoPP::ECB_Mode_ExternalCipher::Encryption encryptor { schedule };
+
+    return encrypt_string(text_for_encoding, encryptor);
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const std::string &key) override {
+    auto schedule { get_decryptor(key) };
+    CryptoPP::ECB_Mode_ExternalCipher::Decryption decryptor { schedule };
+
+    return decrypt_string(text_for_decoding, decryptor);
+  }
+
+  std::unique_ptr<PreparedKey> prepare_key(const std::string &key) override {
+    const TraceSpan span { "aes.prepare_key" };
+    return std::make_unique<CryptoLibAESKey>(key);
+  }
+
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    CryptoPP::ECB_Mode_ExternalCipher::Encryption encryptor { key_cast<CryptoLibAESKey>(key).encryption };
+
+    return encrypt_string(text_for_encoding, encryptor);
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    CryptoPP::ECB_Mode_ExternalCipher::Decryption decryptor { key_cast<CryptoLibAESKey>(key).decryption };
+
+    return decrypt_string(text_for_decoding, decryptor);
+  }
+
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    const TraceSpan span { "aes.encrypt_into" };
+    CryptoPP::ECB_Mode_ExternalCipher::Encryption encryptor { key_cast<CryptoLibAESKey>(key).encryption };
+    return encrypt_blocks(in, out, encryptor);
+  }
+
+  SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const TraceSpan span { "aes.decrypt_into" };
+    const auto *aes_key { try_key_cast<CryptoLibAESKey>(key) };
+    if (aes_key == nullptr) {
+      return std::unexpected { foreign_key_error };
+    }
+
+    CryptoPP::ECB_Mode_ExternalCipher::Decryption decryptor { aes_key->decryption };
+    return decrypt_blocks(in, out, decryptor);
+  }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<CryptoLibAESEncryptionStream>(codec.get_encoding());
+  }
+
+  std::unique_ptr<CryptoStream> create_decryption_stream() override {
+    return std::make_unique<CryptoLibAESDecryptionStream>(codec.get_encoding());
+  }
+
+  // PKCS padding always adds up to a whole block, which the encoding then expands.
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override {
+    return codec.get_encoded_size((text_size / block_size + 1) * block_size);
+  }
+
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override {
+    return codec.get_max_decoded_size(text_size);
+  }
+
+  // Drops the expanded key from both caches, e.g. after the key was rotated.
+  void forget_key(const std::string &key) {
+    std::lock_guard lock { caches_mutex };
+    encryptors.evict(key);
+    decryptors.evict(key);
+  }
+
+  // For inspection while no other thread uses the implementation.
+  const KeyScheduleCache<Encryptor> &get_encryptors() const noexcept { return encryptors; }
+
+  const KeyScheduleCache<Decryptor> &get_decryptors() const noexcept { return decryptors; }
+
+ private:
+  static constexpr std::size_t block_size { CryptoPP::AES::BLOCKSIZE };
+  // Whole AES blocks and whole Base64 groups, so the encoded buffers join up.
+  static constexpr std::size_t buffer_size { (1 << 12) / 48 * 48 };
+
+  // A miss expands the key schedule, which is the SetKey cost. Returns a copy the caller owns.
+  Encryptor get_encryptor(const std::string &key) {
+    const TraceSpan span { "aes.key_schedule" };
+    std::lock_guard lock { caches_mutex };
+    return encryptors.get(key);
+  }
+
+  Decryptor get_decryptor(const std::string &key) {
+    const TraceSpan span { "aes.key_schedule" };
+    std::lock_guard lock { caches_mutex };
+    return decryptors.get(key);
+  }
+
+  std::string encrypt_string(const std::string &text_for_encoding, CryptoPP::StreamTransformation &encryptor) {
+    const TraceSpan span { "aes.encrypt_string" };
+    std::string result(max_encrypted_size(text_for_encoding.size()), '\0');
+    result.resize(encrypt_blocks(std::as_bytes(std::span { text_for_encoding }),
+                                 std::as_writable_bytes(std::span { result }), encryptor));
+    return result;
+  }
+
+  std::string decrypt_string(const std::string &text_for_decoding, CryptoPP::StreamTransformation &decryptor) {
+    const TraceSpan span { "aes.decrypt_string" };
+    std::string result(max_decrypted_size(text_for_decoding.size()), '\0');
+    const auto size { decrypt_blocks(std::as_bytes(std::span { text_for_decoding }),
+                                     std::as_writable_bytes(std::span { result }), decryptor) };
+    if (size.has_value() == false) {
+      throw_exception(size.error());
+    }
+
+    result.resize(*size);
+    return result;
+  }
+
+  // Pads and encodes by hand, a buffer at a time, so nothing is allocated. Raw output is encrypted straight into out.
+  std::size_t encrypt_blocks(std::span<const std::byte> in, std::span<std::byte> out,
+                             CryptoPP::StreamTransformation &encryptor) noexcept {
+    const auto *text { reinterpret_cast<const CryptoPP::byte *>(in.data()) };
+    auto *encoded { reinterpret_cast<char *>(out.data()) };
+    // PKCS #7, the same padding the StreamTransformationFilter adds.
+    const auto padded_size { (in.size() / block_size + 1) * block_size };
+    const auto padding { static_cast<CryptoPP::byte>(padded_size - in.size()) };
+    const auto is_raw { codec.get_encoding() == TextEncoding::RAW };
+
+    std::array<CryptoPP::byte, buffer_size> buffer;
+    for (std::size_t offset {}; offset < padded_size; offset += buffer.size()) {
+      const auto part { std::min(buffer.size(), padded_size - offset) };
+      auto *encrypted { is_raw ? reinterpret_cast<CryptoPP::byte *>(encoded + offset) : buffer.data() };
+      if (offset + part <= in.size()) {
+        encryptor.ProcessData(encrypted, text + offset, part);
+      } else {
+        const auto rest { in.size() - offset };
+        std::copy_n(text + offset, rest, encrypted);
+        std::fill(encrypted + rest, encrypted + part, padding);
+        encryptor.ProcessData(encrypted, encrypted, part);
+      }
+
+      if (is_raw == false) {
+        codec.encode(encrypted, part, encoded + codec.get_encoded_size(offset));
+      }
+    }
+
+    return codec.get_encoded_size(padded_size);
+  }
+
+  // Decodes straight into out and decrypts there. Broken ciphertext is reported without throwing, ECB over a valid key
+  // schedule can't fail otherwise.
+  SizeOrError decrypt_blocks(std::span<const std::byte> in, std::span<std::byte> out,
+                             CryptoPP::StreamTransformation &decryptor) noexcept {
+    auto *decrypted { reinterpret_cast<CryptoPP::byte *>(out.data()) };
+    const auto size { codec.get_encoding() == TextEncoding::RAW
+                          ? std::optional { in.size() }
+                          : codec.decode(reinterpret_cast<const char *>(in.data()), in.size(), decrypted) };
+    if (size.has_value() == false || *size == 0 || *size % block_size != 0) {
+      return std::unexpected { broken_ciphertext_error };
+    }
+
+    if (codec.get_encoding() == TextEncoding::RAW) {
+      decryptor.ProcessData(decrypted, reinterpret_cast<const CryptoPP::byte *>(in.data()), *size);
+    } else {
+      decryptor.ProcessData(decrypted, decrypted, *size);
+    }
+
+    const auto padding { decrypted[*size - 1] };
+    if (padding == 0 || padding > block_size ||
+        std::any_of(decrypted + *size - padding, decrypted + *size, [padding](auto ch) { return ch != padding; })) {
+      return std::unexpected { broken_ciphertext_error };
+    }
+
+    return *size - padding;
+  }
+
+  TextCodec codec;
+  std::mutex caches_mutex;
+  KeyScheduleCache<Encryptor> encryptors;
+  KeyScheduleCache<Decryptor> decryptors;
+};
+
 class AESCryptoStrategy : public CryptoStrategy {
  private:
   std::shared_ptr<AESImplementation> impl;
@@ -82,6 +385,9 @@ class AESCryptoStrategy : public CryptoStrategy {
  public:
   AESCryptoStrategy(AESImplementation *impl = new CryptoLibAESImplementation) : impl { impl } {}
 
+  explicit AESCryptoStrategy(TextEncoding encoding)
+      : impl { new CryptoLibAESImplementation { CryptoLibAESImplementation::default_key_cache_capacity, encoding } } {}
+
   std::string encrypt(const std::string &text_for_encoding, const std::any &any) override {
     return impl->encrypt(text_for_encoding, std::any_cast<const char *>(any));
   }
@@ -90,6 +396,46 @@ class AESCryptoStrategy : public CryptoStrategy {
     return impl->decrypt(text_for_decoding, std::any_cast<const char *>(any));
   }
 
+  std::unique_ptr<PreparedKey> prepare_key(const char *key) override { return impl->prepare_key(key); }
+
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    return impl->encrypt(text_for_encoding, key);
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    return impl->decrypt(text_for_decoding, key);
+  }
+
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    check_output_size(out.size(), max_encrypted_size(in.size()));
+    return impl->encrypt_into(in, out, key);
+  }
+
+  std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_decrypt_into(in, out, key));
+  }
+
+  SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    if (out.size() < max_decrypted_size(in.size())) {
+      return std::unexpected { output_buffer_is_too_small_error };
+    }
+
+    return impl->try_decrypt_into(in, out, key);
+  }
+
   bool is_key_numeric() noexcept override { return false; }
+
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override {
+    return impl->max_encrypted_size(text_size);
+  }
+
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override {
+    return impl->max_decrypted_size(text_size);
+  }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override { return impl->create_encryption_stream(); }
+
+  std::unique_ptr<CryptoStream> create_decryption_stream() override { return impl->create_decryption_stream(); }
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,257 @@
+#ifndef AES_CTR_CRYPTO_HPP
+#define AES_CTR_CRYPTO_HPP
+
+#include <cryptopp/hex.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include "aes_crypto.hpp"
+#include "errors.hpp"
+#include "parallel_ranges.hpp"
+
+class AESCounterMode {
+ public:
+  static constexpr std::size_t block_size { CryptoPP::AES::BLOCKSIZE };
+
+  using Nonce = std::array<CryptoPP::byte, block_size>;
+  using Cipher = CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption;
+  using RangeCipher = CryptoPP::CTR_Mode_ExternalCipher::Encryption;
+
+  static void check_key(const std::string &key) {
+    if (CryptoPP::AES::StaticGetValidKeyLength(key.size()) != key.size()) {
+      throw_exception(invalid_key_length_error);
+    }
+  }
+};
+
+// The counter is random access, so every range copies the expanded key and starts its own counter at its own offset.
+class AESCounterKey : public PreparedKey {
+ public:
+  explicit AESCounterKey(const std::string &key) {
+    AESCounterMode::check_key(key);
+    block_cipher.SetKey(Utility::cast_to_byte(key), key.size());
+  }
+
+  CryptoPP::AES::Encryption block_cipher;
+};
+
+class AESCounterEncryptionStream : public CryptoLibAESStream {
+ private:
+  CryptoPP::BufferedTransformation *create_pipeline(const std::string &key) override {
+    AESCounterMode::check_key(key);
+
+    AESCounterMode::Nonce nonce;
+    CryptoPP::AutoSeededRandomPool {}.GenerateBlock(nonce.data(), nonce.size());
+    encryptor.SetKeyWithIV(Utility::cast_to_byte(key), key.size(), nonce.data(), nonce.size());
+
+    output.resize(2 * nonce.size());
+    HexCodec::encode(nonce.data(), nonce.size(), output.data());
+    return new CryptoPP::StreamTransformationFilter {
+      encryptor, new CryptoPP::HexEncoder { new CryptoPP::StringSink { output } }
+    };
+  }
+
+  AESCounterMode::Cipher encryptor;
+};
+
+class AESCounterDecryptionStream : public CryptoStream {
+ public:
+  void begin(const std::any &any) override {
+    key = std::any_cast<const char *>(any);
+    AESCounterMode::check_key(key);
+
+    decoded.clear();
+    nonce_size = 0;
+    decoder.reset(new CryptoPP::HexDecoder { new CryptoPP::StringSink { decoded } });
+  }
+
+  std::string update(const std::string &chunk) override {
+    decoder->Put(Utility::cast_to_byte(chunk), chunk.size());
+    return decrypt_decoded();
+  }
+
+  std::string finish() override {
+    decoder->MessageEnd();
+    auto result { decrypt_decoded() };
+    if (nonce_size < nonce.size()) {
+      throw_exception(broken_ciphertext_error);
+    }
+
+    return result;
+  }
+
+ private:
+  std::string decrypt_decoded() {
+    std::size_t offset {};
+    if (nonce_size < nonce.size()) {
+      offset = std::min(nonce.size() - nonce_size, decoded.size());
+      std::copy_n(decoded.begin(), offset, nonce.begin() + nonce_size);
+      nonce_size += offset;
+      if (nonce_size == nonce.size()) {
+        decryptor.SetKeyWithIV(Utility::cast_to_byte(key), key.size(), nonce.data(), nonce.size());
+      }
+    }
+
+    std::string result { decoded.substr(offset) };
+    decoded.clear();
+    decryptor.ProcessString(Utility::cast_to_byte(result), result.size());
+    return result;
+  }
+
+  std::string key;
+  std::string decoded;
+  std::unique_ptr<CryptoPP::BufferedTransformation> decoder;
+  AESCounterMode::Nonce nonce;
+  std::size_t nonce_size {};
+  AESCounterMode::Cipher decryptor;
+};
+
+// AES in counter mode. The output is the hex of a random nonce followed by the ciphertext, which has the same size as
+// the text. Large inputs are split into block-aligned ranges and processed on all cores, hex included.
+class AESCTRCryptoStrategy : public CryptoStrategy {
+ public:
+  explicit AESCTRCryptoStrategy(unsigned threads = std::thread::hardware_concurrency())
+      : threads { std::max(threads, 1u) } {}
+
+  std::string encrypt(const std::string &text_for_encoding, const std::any &any) override {
+    return encrypt(text_for_encoding, AESCounterKey { std::any_cast<const char *>(any) });
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const std::any &any) override {
+    return decrypt(text_for_decoding, AESCounterKey { std::any_cast<const char *>(any) });
+  }
+
+  std::unique_ptr<PreparedKey> prepare_key(const char *key) override { return std::make_unique<AESCounterKey>(key); }
+
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    std::string result(max_encrypted_size(text_for_encoding.size()), '\0');
+    encrypt_into(std::as_bytes(std::span { text_for_encoding }), std::as_writable_bytes(std::span { result }), key);
+    return result;
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    std::string result(max_decrypted_size(text_for_decoding.size()), '\0');
+    decrypt_into(std::as_bytes(std::span { text_for_decoding }), std::as_writable_bytes(std::span { result }), key);
+    return result;
+  }
+
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    AESCounterMode::Nonce nonce;
+    CryptoPP::AutoSeededRandomPool {}.GenerateBlock(nonce.data(), nonce.size());
+    return encrypt_with_nonce_into(in, out, key_cast<AESCounterKey>(key), nonce);
+  }
+
+  std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_decrypt_into(in, out, key));
+  }
+
+  SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const auto *counter_key { try_key_cast<AESCounterKey>(key) };
+    if (counter_key == nullptr) {
+      return std::unexpected { foreign_key_error };
+    }
+    if (in.size() < 2 * AESCounterMode::block_size || in.size() % 2 != 0) {
+      return std::unexpected { broken_ciphertext_error };
+    }
+
+    AESCounterMode::Nonce nonce;
+    const auto *encoded { reinterpret_cast<const char *>(in.data()) };
+    if (HexCodec::decode(encoded, nonce.size(), nonce.data()) == false) {
+      return std::unexpected { broken_ciphertext_error };
+    }
+
+    const auto size { max_decrypted_size(in.size()) };
+    if (out.size() < size) {
+      return std::unexpected { output_buffer_is_too_small_error };
+    }
+
+    auto *decrypted { reinterpret_cast<CryptoPP::byte *>(out.data()) };
+    std::atomic<bool> is_broken { false };
+    const auto decrypt_range { [&](auto begin, auto length) {
+      auto block_cipher { counter_key->block_cipher };
+      AESCounterMode::RangeCipher cipher { block_cipher, nonce.data() };
+      cipher.Seek(begin);
+      std::array<CryptoPP::byte, buffer_size> buffer;
+      for (std::size_t offset {}; offset < length; offset += buffer.size()) {
+        const auto part { std::min(buffer.size(), length - offset) };
+        if (HexCodec::decode(encoded + 2 * (nonce.size() + begin + offset), part, buffer.data()) == false) {
+          is_broken = true;
+          return;
+        }
+        cipher.ProcessData(decrypted + begin + offset, buffer.data(), part);
+      }
+    } };
+    const auto result { catch_error([&] {
+      ParallelRanges::run(size, threads, AESCounterMode::block_size, min_range_size, decrypt_range);
+      return size;
+    }) };
+
+    if (result.has_value() && is_broken) {
+      return std::unexpected { broken_ciphertext_error };
+    }
+
+    return result;
+  }
+
+  // The nonce must never repeat for the same key.
+  std::string encrypt_with_nonce(const std::string &text, const AESCounterKey &key,
+                                 const AESCounterMode::Nonce &nonce) {
+    std::string result(max_encrypted_size(text.size()), '\0');
+    const std::span output { result };
+    encrypt_with_nonce_into(std::as_bytes(std::span { text }), std::as_writable_bytes(output), key, nonce);
+    return result;
+  }
+
+  std::size_t encrypt_with_nonce_into(std::span<const std::byte> in, std::span<std::byte> out,
+                                      const AESCounterKey &counter_key, const AESCounterMode::Nonce &nonce) {
+    check_output_size(out.size(), max_encrypted_size(in.size()));
+
+    const auto *text { reinterpret_cast<const CryptoPP::byte *>(in.data()) };
+    auto *encoded { reinterpret_cast<char *>(out.data()) };
+    HexCodec::encode(nonce.data(), nonce.size(), encoded);
+
+    const auto encrypt_range { [&](auto begin, auto length) {
+      auto block_cipher { counter_key.block_cipher };
+      AESCounterMode::RangeCipher cipher { block_cipher, nonce.data() };
+      cipher.Seek(begin);
+      std::array<CryptoPP::byte, buffer_size> buffer;
+      for (std::size_t offset {}; offset < length; offset += buffer.size()) {
+        const auto part { std::min(buffer.size(), length - offset) };
+        cipher.ProcessData(buffer.data(), text + begin + offset, part);
+        HexCodec::encode(buffer.data(), part, encoded + 2 * (nonce.size() + begin + offset));
+      }
+    } };
+    ParallelRanges::run(in.size(), threads, AESCounterMode::block_size, min_range_size, encrypt_range);
+
+    return max_encrypted_size(in.size());
+  }
+
+  bool is_key_numeric() noexcept override { return false; }
+
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override {
+    return 2 * (AESCounterMode::block_size + text_size);
+  }
+
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override {
+    return text_size / 2 - std::min(text_size / 2, AESCounterMode::block_size);
+  }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<AESCounterEncryptionStream>();
+  }
+
+  std::unique_ptr<CryptoStream> create_decryption_stream() override {
+    return std::make_unique<AESCounterDecryptionStream>();
+  }
+
+ private:
+  static constexpr std::size_t min_range_size { 1 << 18 };
+  static constexpr std::size_t buffer_size { 1 << 14 };
+
+  unsigned threads;
+};
+
+#endif
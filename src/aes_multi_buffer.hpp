@@ -0,0 +1,320 @@
+#ifndef AES_MULTI_BUFFER_HPP
+#define AES_MULTI_BUFFER_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "cpu_features.hpp"
+#include "errors.hpp"
+
+// An expanded AES key as FIPS-197 defines it, laid out for the AES-NI instructions. The decryption keys are those of
+// the equivalent inverse cipher, which aesdec implements.
+class AESRoundKeys {
+ public:
+  static constexpr std::size_t block_size { 16 };
+  static constexpr std::size_t max_rounds_count { 14 };
+
+  using Block = std::array<std::uint8_t, block_size>;
+
+  // Throws when the key is not 16, 24 or 32 bytes long.
+  explicit AESRoundKeys(std::string_view key) {
+    if (key.size() != 16 && key.size() != 24 && key.size() != 32) {
+      throw_exception(invalid_key_length_error);
+    }
+
+    expand(key);
+  }
+
+  std::size_t rounds_count;
+  std::array<Block, max_rounds_count + 1> encryption;
+  std::array<Block, max_rounds_count + 1> decryption;
+
+ private:
+  static constexpr std::uint8_t multiply_by_x(std::uint8_t value) noexcept {
+    return static_cast<std::uint8_t>(value << 1 ^ (value & 0x80 ? 0x1b : 0));
+  }
+
+  static constexpr std::uint8_t multiply(std::uint8_t value, std::uint8_t factor) noexcept {
+    std::uint8_t result {};
+    for (; factor != 0; factor >>= 1, value = multiply_by_x(value)) {
+      result ^= factor & 1 ? value : 0;
+    }
+    return result;
+  }
+
+  // Walks the powers of 3 and of its inverse together, so every byte meets its inverse without a division.
+  static constexpr std::array<std::uint8_t, 256> make_s_box() noexcept {
+    std::array<std::uint8_t, 256> result {};
+    std::uint8_t power { 1 };
+    std::uint8_t inverse { 1 };
+    do {
+      power = static_cast<std::uint8_t>(power ^ multiply_by_x(power));
+      inverse ^= static_cast<std::uint8_t>(inverse << 1);
+      inverse ^= static_cast<std::uint8_t>(inverse << 2);
+      inverse ^= static_cast<std::uint8_t>(inverse << 4);
+      inverse ^= inverse & 0x80 ? 0x09 : 0;
+      result[power] = inverse ^ std::rotl(inverse, 1) ^ std::rotl(inverse, 2) ^ std::rotl(inverse, 3) ^
+                      std::rotl(inverse, 4) ^ 0x63;
+    } while (power != 1);
+    result[0] = 0x63;
+    return result;
+  }
+
+  static const std::array<std::uint8_t, 256> s_box;
+
+  // The words hold the key bytes in memory order, so the first byte of a word is its lowest.
+  static std::uint32_t substitute(std::uint32_t word) noexcept {
+    std::uint32_t result {};
+    for (auto shift { 0 }; shift < 32; shift += 8) {
+      result |= static_cast<std::uint32_t>(s_box[word >> shift & 0xff]) << shift;
+    }
+    return result;
+  }
+
+  void expand(std::string_view key) noexcept {
+    const auto key_words_count { key.size() / 4 };
+    rounds_count = key_words_count + 6;
+
+    std::array<std::uint32_t, 4 * (max_rounds_count + 1)> words;
+    std::memcpy(words.data(), key.data(), key.size());
+    std::uint8_t round_constant { 1 };
+    for (auto i { key_words_count }; i < 4 * (rounds_count + 1); ++i) {
+      auto word { words[i - 1] };
+      if (i % key_words_count == 0) {
+        word = substitute(std::rotr(word, 8)) ^ round_constant;
+        round_constant = multiply_by_x(round_constant);
+      } else if (key_words_count > 6 && i % key_words_count == 4) {
+        word = substitute(word);
+      }
+      words[i] = words[i - key_words_count] ^ word;
+    }
+    std::memcpy(encryption.data(), words.data(), (rounds_count + 1) * block_size);
+
+    decryption[0] = encryption[rounds_count];
+    for (std::size_t round { 1 }; round < rounds_count; ++round) {
+      decryption[round] = mix_columns_back(encryption[rounds_count - round]);
+    }
+    decryption[rounds_count] = encryption[0];
+  }
+
+  static Block mix_columns_back(const Block &block) noexcept {
+    Block result;
+    for (std::size_t column {}; column < block_size; column += 4) {
+      for (std::size_t row {}; row < 4; ++row) {
+        result[column + row] = multiply(block[column + row], 14) ^ multiply(block[column + (row + 1) % 4], 11) ^
+                               multiply(block[column + (row + 2) % 4], 13) ^ multiply(block[column + (row + 3) % 4], 9);
+      }
+    }
+    return result;
+  }
+};
+
+inline constexpr std::array<std::uint8_t, 256> AESRoundKeys::s_box { AESRoundKeys::make_s_box() };
+
+// A message of whole blocks: where it is read from, where it goes, which may be the same place, and with which key.
+struct AESMessageJob {
+  const std::uint8_t *in;
+  std::uint8_t *out;
+  std::size_t blocks_count;
+  const AESRoundKeys *keys;
+};
+
+// Runs the blocks of many independent messages through AES side by side. A single short message keeps the unit waiting
+// on each round of a handful of blocks, here a group always has lanes_count blocks in flight, whichever messages they
+// belong to. The groups take the blocks in message order, so the memory is still read and written front to back. With
+// a shared key the round keys are loaded once per round for the whole group, otherwise every lane loads its own.
+class AESMultiBuffer {
+ public:
+  // Blocks in flight with AES-NI, twice as many with VAES.
+  static constexpr std::size_t lanes_count { 8 };
+
+  static bool is_supported() noexcept { return CpuFeatures::has_aes_ni(); }
+
+  // All keys of one call must have the same length. Without a shared key every job brings its own.
+  static void encrypt(std::span<const AESMessageJob> jobs, const AESRoundKeys *shared_keys = nullptr) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_vaes()) {
+      return run_vaes<true>(jobs, shared_keys);
+    }
+    run_aes_ni<true>(jobs, shared_keys);
+#endif
+  }
+
+  static void decrypt(std::span<const AESMessageJob> jobs, const AESRoundKeys *shared_keys = nullptr) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_vaes()) {
+      return run_vaes<false>(jobs, shared_keys);
+    }
+    run_aes_ni<false>(jobs, shared_keys);
+#endif
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  template <bool is_encryption>
+  __attribute__((target("aes"))) static void run_aes_ni(std::span<const AESMessageJob> jobs,
+                                                         const AESRoundKeys *shared_keys) noexcept {
+    for (Group<lanes_count> group { jobs }; group.fill();) {
+      process_group<is_encryption>(group, shared_keys);
+    }
+  }
+
+  template <bool is_encryption>
+  __attribute__((target("aes,vaes,avx2"))) static void run_vaes(std::span<const AESMessageJob> jobs,
+                                                                const AESRoundKeys *shared_keys) noexcept {
+    for (Group<2 * lanes_count> group { jobs }; group.fill();) {
+      process_group_vaes<is_encryption>(group, shared_keys);
+    }
+  }
+#endif
+
+ private:
+  using Block = AESRoundKeys::Block;
+
+  // The blocks in flight, the next group_size blocks of the messages in order. The lanes past the last block get a
+  // scratch block, so the kernels always run whole groups.
+  template <std::size_t group_size>
+  class Group {
+   public:
+    explicit Group(std::span<const AESMessageJob> jobs) noexcept : jobs { jobs } { skip_empty_jobs(); }
+
+    // False when no blocks are left. The lanes are filled a run of blocks of one message at a time.
+    bool fill() noexcept {
+      if (next == jobs.size()) {
+        return false;
+      }
+
+      std::size_t lane {};
+      while (lane < group_size && next < jobs.size()) {
+        const auto &job { jobs[next] };
+        const auto count { std::min(group_size - lane, job.blocks_count - taken_count) };
+        const auto offset { taken_count * AESRoundKeys::block_size };
+        for (std::size_t i {}; i < count; ++i) {
+          in[lane + i] = job.in + offset + i * AESRoundKeys::block_size;
+          out[lane + i] = job.out + offset + i * AESRoundKeys::block_size;
+          keys[lane + i] = job.keys;
+        }
+        lane += count;
+        taken_count += count;
+        if (taken_count == job.blocks_count) {
+          ++next;
+          taken_count = 0;
+          skip_empty_jobs();
+        }
+      }
+
+      for (; lane < group_size; ++lane) {
+        in[lane] = out[lane] = scratch.data();
+        keys[lane] = keys[0];
+      }
+      return true;
+    }
+
+    const std::uint8_t *in[group_size];
+    std::uint8_t *out[group_size];
+    const AESRoundKeys *keys[group_size];
+
+   private:
+    void skip_empty_jobs() noexcept {
+      for (; next < jobs.size() && jobs[next].blocks_count == 0; ++next) {
+      }
+    }
+
+    std::span<const AESMessageJob> jobs;
+    std::size_t next {};
+    std::size_t taken_count {};
+    Block scratch {};
+  };
+
+#ifdef CRYPTO_X86_KERNELS
+  template <std::size_t group_size>
+  static const AESRoundKeys &get_keys(const Group<group_size> &group, std::size_t lane,
+                                      const AESRoundKeys *shared_keys) noexcept {
+    return shared_keys == nullptr ? *group.keys[lane] : *shared_keys;
+  }
+
+  template <bool is_encryption>
+  __attribute__((target("aes"))) static __m128i load_key(const AESRoundKeys &keys, std::size_t round) noexcept {
+    const auto &key { is_encryption ? keys.encryption[round] : keys.decryption[round] };
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(key.data()));
+  }
+
+  template <bool is_encryption>
+  __attribute__((target("aes"), always_inline)) static void process_group(const Group<lanes_count> &group,
+                                                                         const AESRoundKeys *shared_keys) noexcept {
+    const auto rounds_count { get_keys(group, 0, shared_keys).rounds_count };
+    __m128i blocks[lanes_count];
+#pragma GCC unroll 8
+    for (std::size_t lane {}; lane < lanes_count; ++lane) {
+      const auto block { _mm_loadu_si128(reinterpret_cast<const __m128i *>(group.in[lane])) };
+      blocks[lane] = _mm_xor_si128(block, load_key<is_encryption>(get_keys(group, lane, shared_keys), 0));
+    }
+
+    for (std::size_t round { 1 }; round < rounds_count; ++round) {
+#pragma GCC unroll 8
+      for (std::size_t lane {}; lane < lanes_count; ++lane) {
+        const auto key { load_key<is_encryption>(get_keys(group, lane, shared_keys), round) };
+        blocks[lane] = is_encryption ? _mm_aesenc_si128(blocks[lane], key) : _mm_aesdec_si128(blocks[lane], key);
+      }
+    }
+
+#pragma GCC unroll 8
+    for (std::size_t lane {}; lane < lanes_count; ++lane) {
+      const auto key { load_key<is_encryption>(get_keys(group, lane, shared_keys), rounds_count) };
+      const auto block { is_encryption ? _mm_aesenclast_si128(blocks[lane], key)
+                                       : _mm_aesdeclast_si128(blocks[lane], key) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(group.out[lane]), block);
+    }
+  }
+
+  // Two lanes per register, so two blocks and, without a shared key, two round keys are paired up.
+  template <bool is_encryption>
+  __attribute__((target("aes,vaes,avx2"))) static __m256i load_key_pair(const Group<2 * lanes_count> &group,
+                                                                   std::size_t pair, const AESRoundKeys *shared_keys,
+                                                                   std::size_t round) noexcept {
+    if (shared_keys != nullptr) {
+      return _mm256_broadcastsi128_si256(load_key<is_encryption>(*shared_keys, round));
+    }
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(load_key<is_encryption>(*group.keys[2 * pair], round)),
+                                   load_key<is_encryption>(*group.keys[2 * pair + 1], round), 1);
+  }
+
+  template <bool is_encryption>
+  __attribute__((target("aes,vaes,avx2"), always_inline)) static void process_group_vaes(
+      const Group<2 * lanes_count> &group, const AESRoundKeys *shared_keys) noexcept {
+    const auto rounds_count { get_keys(group, 0, shared_keys).rounds_count };
+    __m256i blocks[lanes_count];
+#pragma GCC unroll 8
+    for (std::size_t pair {}; pair < lanes_count; ++pair) {
+      const auto first { _mm_loadu_si128(reinterpret_cast<const __m128i *>(group.in[2 * pair])) };
+      const auto second { _mm_loadu_si128(reinterpret_cast<const __m128i *>(group.in[2 * pair + 1])) };
+      blocks[pair] = _mm256_xor_si256(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1),
+                                      load_key_pair<is_encryption>(group, pair, shared_keys, 0));
+    }
+
+    for (std::size_t round { 1 }; round < rounds_count; ++round) {
+#pragma GCC unroll 8
+      for (std::size_t pair {}; pair < lanes_count; ++pair) {
+        const auto key { load_key_pair<is_encryption>(group, pair, shared_keys, round) };
+        blocks[pair] = is_encryption ? _mm256_aesenc_epi128(blocks[pair], key)
+                                     : _mm256_aesdec_epi128(blocks[pair], key);
+      }
+    }
+
+#pragma GCC unroll 8
+    for (std::size_t pair {}; pair < lanes_count; ++pair) {
+      const auto key { load_key_pair<is_encryption>(group, pair, shared_keys, rounds_count) };
+      const auto block { is_encryption ? _mm256_aesenclast_epi128(blocks[pair], key)
+                                       : _mm256_aesdeclast_epi128(blocks[pair], key) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(group.out[2 * pair]), _mm256_castsi256_si128(block));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(group.out[2 * pair + 1]), _mm256_extracti128_si256(block, 1));
+    }
+  }
+#endif
+};
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef BASE64_CODEC_HPP
+#define BASE64_CODEC_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "cpu_features.hpp"
+
+// Standard Base64 with '=' padding, like CryptoPP::Base64Encoder without line breaks, straight between caller buffers.
+// The vector kernels spread every 3 bytes over 4 lanes of 6 bits and map those to chars with range compares, after
+// Muła and Lemire.
+class Base64Codec {
+ public:
+  static constexpr std::size_t get_encoded_size(std::size_t size) noexcept { return (size + 2) / 3 * 4; }
+
+  static constexpr std::size_t get_max_decoded_size(std::size_t size) noexcept { return size / 4 * 3; }
+
+  // Writes exactly get_encoded_size(size) chars. Parts of one text can be encoded separately when all but the last one
+  // have a multiple of 3 bytes.
+  static void encode(const std::uint8_t *decoded, std::size_t size, char *encoded) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_avx2()) {
+      return encode_avx2(decoded, size, encoded);
+    }
+    if (CpuFeatures::has_ssse3()) {
+      return encode_ssse3(decoded, size, encoded);
+    }
+#endif
+    encode_scalar(decoded, size, encoded);
+  }
+
+  // Reads whole groups of 4 chars, padding is allowed in the last one only. Returns the decoded size, or nothing when a
+  // char is not Base64 or the size is not a multiple of 4.
+  static std::optional<std::size_t> decode(const char *encoded, std::size_t size, std::uint8_t *decoded) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_avx2()) {
+      return decode_avx2(encoded, size, decoded);
+    }
+    if (CpuFeatures::has_ssse3()) {
+      return decode_ssse3(encoded, size, decoded);
+    }
+#endif
+    return decode_scalar(encoded, size, decoded);
+  }
+
+  static void encode_scalar(const std::uint8_t *decoded, std::size_t size, char *encoded) noexcept {
+    for (; size >= 3; size -= 3, decoded += 3, encoded += 4) {
+      const auto group { static_cast<std::uint32_t>(decoded[0] << 16 | decoded[1] << 8 | decoded[2]) };
+      encoded[0] = alphabet[group >> 18];
+      encoded[1] = alphabet[group >> 12 & 0x3f];
+      encoded[2] = alphabet[group >> 6 & 0x3f];
+      encoded[3] = alphabet[group & 0x3f];
+    }
+
+    if (size == 0) {
+      return;
+    }
+
+    const auto group { static_cast<std::uint32_t>(decoded[0] << 16 | (size == 2 ? decoded[1] << 8 : 0)) };
+    encoded[0] = alphabet[group >> 18];
+    encoded[1] = alphabet[group >> 12 & 0x3f];
+    encoded[2] = size == 2 ? alphabet[group >> 6 & 0x3f] : padding;
+    encoded[3] = padding;
+  }
+
+  static std::optional<std::size_t> decode_scalar(const char *encoded, std::size_t size,
+                                                  std::uint8_t *decoded) noexcept {
+    if (size % 4 != 0) {
+      return std::nullopt;
+    }
+
+    const auto padding_size { get_padding_size(encoded, size) };
+    const auto whole_size { size - (padding_size == 0 ? 0 : 4) };
+    auto *begin { decoded };
+    for (std::size_t i {}; i < whole_size; i += 4, decoded += 3) {
+      const auto group { get_group(encoded + i) };
+      if (group > 0xffffff) {
+        return std::nullopt;
+      }
+      decoded[0] = static_cast<std::uint8_t>(group >> 16);
+      decoded[1] = static_cast<std::uint8_t>(group >> 8);
+      decoded[2] = static_cast<std::uint8_t>(group);
+    }
+
+    if (padding_size != 0) {
+      // The padded chars count as zero bits, the bits they would hold must be zero as well.
+      std::array<char, 4> last;
+      std::copy_n(encoded + whole_size, 4, last.begin());
+      std::fill(last.end() - padding_size, last.end(), alphabet[0]);
+      const auto group { get_group(last.data()) };
+      if (group > 0xffffff || (group & (padding_size == 1 ? 0xff : 0xffff)) != 0) {
+        return std::nullopt;
+      }
+      decoded[0] = static_cast<std::uint8_t>(group >> 16);
+      if (padding_size == 1) {
+        decoded[1] = static_cast<std::uint8_t>(group >> 8);
+      }
+      decoded += 3 - padding_size;
+    }
+
+    return static_cast<std::size_t>(decoded - begin);
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // Loads 16 bytes and encodes the first 12 of them.
+  __attribute__((target("ssse3"))) static void encode_ssse3(const std::uint8_t *decoded, std::size_t size,
+                                                             char *encoded) noexcept {
+    std::size_t i {};
+    for (; i + 16 <= size; i += 12, encoded += 16) {
+      const auto bytes { _mm_loadu_si128(reinterpret_cast<const __m128i *>(decoded + i)) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(encoded), to_chars(split_groups(bytes)));
+    }
+
+    encode_scalar(decoded + i, size - i, encoded);
+  }
+
+  // Every lane loads 16 bytes and encodes the first 12, so 28 bytes must be readable.
+  __attribute__((target("avx2"))) static void encode_avx2(const std::uint8_t *decoded, std::size_t size,
+                                                           char *encoded) noexcept {
+    std::size_t i {};
+    for (; i + 28 <= size; i += 24, encoded += 32) {
+      const auto first { _mm_loadu_si128(reinterpret_cast<const __m128i *>(decoded + i)) };
+      const auto second { _mm_loadu_si128(reinterpret_cast<const __m128i *>(decoded + i + 12)) };
+      const auto bytes { _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1) };
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(encoded), to_chars(split_groups(bytes)));
+    }
+
+    encode_scalar(decoded + i, size - i, encoded);
+  }
+
+  // Decodes 16 chars into 12 bytes and stores 16, so the loop stops while the output has room and before the last
+  // group, which may be padded.
+  __attribute__((target("ssse3"))) static std::optional<std::size_t> decode_ssse3(const char *encoded, std::size_t size,
+                                                                                 std::uint8_t *decoded) noexcept {
+    if (size % 4 != 0) {
+      return std::nullopt;
+    }
+
+    std::size_t i {};
+    for (; i + 24 <= size; i += 16, decoded += 12) {
+      __m128i values;
+      if (to_values(_mm_loadu_si128(reinterpret_cast<const __m128i *>(encoded + i)), values) == false) {
+        return std::nullopt;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(decoded), join_groups(values));
+    }
+
+    return add(i / 4 * 3, decode_scalar(encoded + i, size - i, decoded));
+  }
+
+  __attribute__((target("avx2"))) static std::optional<std::size_t> decode_avx2(const char *encoded, std::size_t size,
+                                                                               std::uint8_t *decoded) noexcept {
+    if (size % 4 != 0) {
+      return std::nullopt;
+    }
+
+    std::size_t i {};
+    for (; i + 48 <= size; i += 32, decoded += 24) {
+      __m256i values;
+      if (to_values(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(encoded + i)), values) == false) {
+        return std::nullopt;
+      }
+      // Each lane holds its 12 bytes at the bottom, the permute closes the gap between them.
+      const auto joined { _mm256_permutevar8x32_epi32(join_groups(values), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)) };
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(decoded), joined);
+    }
+
+    return add(i / 4 * 3, decode_ssse3(encoded + i, size - i, decoded));
+  }
+#endif
+
+ private:
+  static constexpr const char *alphabet { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+  static constexpr char padding { '=' };
+  static constexpr std::uint8_t invalid { 0xff };
+
+  static std::size_t get_padding_size(const char *encoded, std::size_t size) noexcept {
+    if (size == 0 || encoded[size - 1] != padding) {
+      return 0;
+    }
+    return encoded[size - 2] == padding ? 2 : 1;
+  }
+
+  // Above 0xffffff when a char is not Base64.
+  static std::uint32_t get_group(const char *encoded) noexcept {
+    std::uint32_t group {};
+    for (auto i { 0 }; i < 4; ++i) {
+      const auto value { values[static_cast<std::uint8_t>(encoded[i])] };
+      group = value == invalid ? 0xffffffff : group << 6 | value;
+      if (value == invalid) {
+        break;
+      }
+    }
+    return group;
+  }
+
+  static std::optional<std::size_t> add(std::size_t size, std::optional<std::size_t> rest) noexcept {
+    return rest.has_value() ? std::optional { size + *rest } : std::nullopt;
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // The bytes a b c of a group go to a 32-bit lane as b a c b, the multiplies move its four 6-bit fields to the bottom
+  // of the four bytes.
+  __attribute__((target("ssse3"))) static __m128i split_groups(__m128i bytes) noexcept {
+    const auto lanes { _mm_shuffle_epi8(bytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)) };
+    const auto high { _mm_mulhi_epu16(_mm_and_si128(lanes, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040)) };
+    const auto low { _mm_mullo_epi16(_mm_and_si128(lanes, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010)) };
+    return _mm_or_si128(high, low);
+  }
+
+  __attribute__((target("avx2"))) static __m256i split_groups(__m256i bytes) noexcept {
+    const auto order { _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7,
+                                        6, 8, 7, 10, 9, 11, 10) };
+    const auto lanes { _mm256_shuffle_epi8(bytes, order) };
+    const auto high { _mm256_mulhi_epu16(_mm256_and_si256(lanes, _mm256_set1_epi32(0x0fc0fc00)),
+                                         _mm256_set1_epi32(0x04000040)) };
+    const auto low { _mm256_mullo_epi16(_mm256_and_si256(lanes, _mm256_set1_epi32(0x003f03f0)),
+                                        _mm256_set1_epi32(0x01000010)) };
+    return _mm256_or_si256(high, low);
+  }
+
+  // 0..25 is offset to 'A', 26..51 to 'a', 52..61 to '0', then '+' and '/'. The saturated subtraction gives every range
+  // its own index into the table of offsets.
+  __attribute__((target("ssse3"))) static __m128i to_chars(__m128i values) noexcept {
+    const auto offsets { _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0) };
+    const auto ranges { _mm_sub_epi8(_mm_subs_epu8(values, _mm_set1_epi8(51)),
+                                     _mm_cmpgt_epi8(values, _mm_set1_epi8(25))) };
+    return _mm_add_epi8(values, _mm_shuffle_epi8(offsets, ranges));
+  }
+
+  __attribute__((target("avx2"))) static __m256i to_chars(__m256i values) noexcept {
+    const auto offsets { _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0, 65, 71, -4,
+                                          -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0) };
+    const auto ranges { _mm256_sub_epi8(_mm256_subs_epu8(values, _mm256_set1_epi8(51)),
+                                        _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25))) };
+    return _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, ranges));
+  }
+
+  // The inverse of to_chars, false when any char is not Base64.
+  __attribute__((target("ssse3"))) static bool to_values(__m128i chars, __m128i &values) noexcept {
+    const auto upper { SimdBytes::in_range(chars, 'A', 'Z') };
+    const auto lower { SimdBytes::in_range(chars, 'a', 'z') };
+    const auto digit { SimdBytes::in_range(chars, '0', '9') };
+    const auto plus { _mm_cmpeq_epi8(chars, _mm_set1_epi8('+')) };
+    const auto slash { _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')) };
+    const auto valid { _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash))) };
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+      return false;
+    }
+
+    const auto offsets { _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-65)), _mm_and_si128(lower, _mm_set1_epi8(-71))),
+        _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(4)),
+                     _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(19)), _mm_and_si128(slash, _mm_set1_epi8(16))))) };
+    values = _mm_add_epi8(chars, offsets);
+    return true;
+  }
+
+  __attribute__((target("avx2"))) static bool to_values(__m256i chars, __m256i &values) noexcept {
+    const auto upper { SimdBytes::in_range(chars, 'A', 'Z') };
+    const auto lower { SimdBytes::in_range(chars, 'a', 'z') };
+    const auto digit { SimdBytes::in_range(chars, '0', '9') };
+    const auto plus { _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+')) };
+    const auto slash { _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')) };
+    const auto valid { _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                       _mm256_or_si256(digit, _mm256_or_si256(plus, slash))) };
+    if (_mm256_movemask_epi8(valid) != -1) {
+      return false;
+    }
+
+    const auto offsets { _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-65)), _mm256_and_si256(lower, _mm256_set1_epi8(-71))),
+        _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(4)),
+                        _mm256_or_si256(_mm256_and_si256(plus, _mm256_set1_epi8(19)),
+                                        _mm256_and_si256(slash, _mm256_set1_epi8(16))))) };
+    values = _mm256_add_epi8(chars, offsets);
+    return true;
+  }
+
+  // Four 6-bit values become one 24-bit group per 32-bit lane, the shuffle writes its bytes high first and leaves the
+  // last 4 bytes of every 16 empty.
+  __attribute__((target("ssse3"))) static __m128i join_groups(__m128i values) noexcept {
+    const auto pairs { _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)) };
+    const auto groups { _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000)) };
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+  }
+
+  __attribute__((target("avx2"))) static __m256i join_groups(__m256i values) noexcept {
+    const auto pairs { _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)) };
+    const auto groups { _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000)) };
+    return _mm256_shuffle_epi8(groups, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1,
+                                                        0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+  }
+#endif
+
+  static constexpr std::array<std::uint8_t, 256> make_values() {
+    std::array<std::uint8_t, 256> result;
+    result.fill(invalid);
+    for (std::uint8_t i {}; i < 64; ++i) {
+      result[static_cast<std::uint8_t>(alphabet[i])] = i;
+    }
+    return result;
+  }
+
+  static const std::array<std::uint8_t, 256> values;
+};
+
+inline constexpr std::array<std::uint8_t, 256> Base64Codec::values { Base64Codec::make_values() };
+
+#endif
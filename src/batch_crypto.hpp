@@ -0,0 +1,130 @@
+#ifndef BATCH_CRYPTO_HPP
+#define BATCH_CRYPTO_HPP
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "crypto_strategy.hpp"
+#include "errors.hpp"
+#include "work_stealing_pool.hpp"
+
+// Records laid out back to back in one buffer, record i is data[offsets[i], offsets[i + 1]).
+class RecordBatch {
+ public:
+  RecordBatch() = default;
+
+  RecordBatch(std::initializer_list<std::string_view> records) {
+    for (auto &&record : records) {
+      push_back(record);
+    }
+  }
+
+  void push_back(std::string_view record) {
+    data += record;
+    offsets.push_back(data.size());
+  }
+
+  std::size_t size() const noexcept { return offsets.size() - 1; }
+
+  std::string_view operator[](std::size_t index) const noexcept {
+    return std::string_view { data }.substr(offsets[index], offsets[index + 1] - offsets[index]);
+  }
+
+  // Keeps the first sizes[i] bytes of every record and moves it right behind the previous one, which drops the slack
+  // of records written into upper bound slots.
+  void compact(const std::vector<std::size_t> &sizes) {
+    std::size_t end {};
+    for (std::size_t index {}; index < sizes.size(); ++index) {
+      const auto begin { offsets[index] };
+      if (begin != end) {
+        std::memmove(data.data() + end, data.data() + begin, sizes[index]);
+      }
+      offsets[index] = end;
+      end += sizes[index];
+    }
+    offsets.back() = end;
+    data.resize(end);
+  }
+
+  std::string data;
+  std::vector<std::size_t> offsets { 0 };
+};
+
+struct BatchResult {
+  RecordBatch records;
+  // One per record, null on success, otherwise the constant from errors.hpp it failed with. A failed record is empty.
+  std::vector<ErrorCode> errors;
+};
+
+// Encrypts many independent records with one strategy and key. The key is prepared once per worker, every record is
+// written straight into its slot of the output buffer through try_encrypt_into, and a failed record only sets its
+// error, without an exception.
+class BatchCrypto {
+ public:
+  static constexpr std::size_t records_per_task { 64 };
+
+  explicit BatchCrypto(CryptoStrategy &strategy, unsigned threads = std::thread::hardware_concurrency())
+      : strategy { strategy }, pool { threads } {}
+
+  // Throws when the key itself is invalid, since then no record could succeed.
+  BatchResult encrypt(const RecordBatch &records, const char *key) { return process(records, key, true); }
+
+  BatchResult decrypt(const RecordBatch &records, const char *key) { return process(records, key, false); }
+
+ private:
+  BatchResult process(const RecordBatch &records, const char *key, bool is_encryption) {
+    // The prepared keys of some strategies hold cipher state, so the workers don't share one.
+    std::vector<std::unique_ptr<PreparedKey>> keys;
+    for (unsigned worker {}; worker < pool.get_threads_count(); ++worker) {
+      keys.push_back(strategy.prepare_key(key));
+    }
+
+    BatchResult result;
+    auto &offsets { result.records.offsets };
+    offsets.resize(records.size() + 1);
+    for (std::size_t index {}; index < records.size(); ++index) {
+      const auto size { records[index].size() };
+      offsets[index + 1] = offsets[index] + (is_encryption ? strategy.max_encrypted_size(size, *keys.front())
+                                                           : strategy.max_decrypted_size(size, *keys.front()));
+    }
+    result.records.data.resize(offsets.back());
+    result.errors.assign(records.size(), nullptr);
+
+    std::vector<std::size_t> sizes(records.size());
+    const auto tasks_count { (records.size() + records_per_task - 1) / records_per_task };
+    pool.run(tasks_count, [&](std::size_t task, unsigned worker) {
+      const auto end { std::min(records.size(), (task + 1) * records_per_task) };
+      for (auto index { task * records_per_task }; index < end; ++index) {
+        const auto out { std::as_writable_bytes(std::span { result.records.data })
+                             .subspan(offsets[index], offsets[index + 1] - offsets[index]) };
+        sizes[index] = process_record(std::as_bytes(std::span { records[index] }), out, *keys[worker], is_encryption,
+                                      result.errors[index]);
+      }
+    });
+
+    result.records.compact(sizes);
+    return result;
+  }
+
+  std::size_t process_record(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key,
+                             bool is_encryption, ErrorCode &error) noexcept {
+    const auto result { is_encryption ? strategy.try_encrypt_into(in, out, key)
+                                      : strategy.try_decrypt_into(in, out, key) };
+    if (result.has_value() == false) {
+      error = result.error();
+      return 0;
+    }
+
+    return *result;
+  }
+
+  CryptoStrategy &strategy;
+  WorkStealingPool pool;
+};
+
+#endif
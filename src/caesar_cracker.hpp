@@ -0,0 +1,94 @@
+#ifndef CAESAR_CRACKER_HPP
+#define CAESAR_CRACKER_HPP
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <mutex>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+
+#include "caesar_crypto.hpp"
+#include "crack_result.hpp"
+#include "errors.hpp"
+#include "letter_histogram.hpp"
+#include "parallel_ranges.hpp"
+
+// Finds the shift of a Caesar ciphertext of English text from a single histogram of its letters. Shifting the text
+// rotates its histogram, so all 26 shifts are scored against the English frequencies without decrypting the text even
+// once. The text can be fed in chunks of any size, only the 26 counts are kept.
+class CaesarCracker {
+ public:
+  struct Candidate {
+    int shift;
+    double chi_squared;
+  };
+
+  // The closest to English first.
+  using Ranking = std::array<Candidate, 26>;
+
+  // Chunks of at least parallel_chunk_size bytes are split over threads, each counting its part into its own
+  // histogram.
+  static constexpr std::size_t parallel_chunk_size { 1 << 22 };
+
+  explicit CaesarCracker(unsigned threads = std::thread::hardware_concurrency()) : threads { threads } {}
+
+  void update(std::string_view chunk) {
+    if (chunk.size() < parallel_chunk_size || threads < 2) {
+      LetterHistogram::count(chunk, counts);
+      return;
+    }
+
+    std::mutex counts_mutex;
+    ParallelRanges::run(chunk.size(), threads, 64, parallel_chunk_size / 4, [&](std::size_t begin, std::size_t length) {
+      const auto range_counts { LetterHistogram::count(chunk.substr(begin, length)) };
+      std::lock_guard lock { counts_mutex };
+      for (std::size_t letter {}; letter < counts.size(); ++letter) {
+        counts[letter] += range_counts[letter];
+      }
+    });
+  }
+
+  // Throws when none of the text seen so far was a letter.
+  Ranking rank() const {
+    if (std::ranges::all_of(counts, [](auto count) { return count == 0; })) {
+      throw_exception(not_enough_letters_error);
+    }
+
+    Ranking ranking;
+    for (auto shift { 0 }; shift < 26; ++shift) {
+      ranking[shift] = { shift, LetterHistogram::chi_squared(counts, shift) };
+    }
+    std::ranges::stable_sort(ranking, {}, &Candidate::chi_squared);
+    return ranking;
+  }
+
+  const LetterHistogram::Counts &get_counts() const noexcept { return counts; }
+
+  static Ranking rank(std::string_view text) {
+    CaesarCracker cracker;
+    cracker.update(text);
+    return cracker.rank();
+  }
+
+  // Only the best shift is decrypted, by CaesarCryptoStrategy, which throws for texts it can't decrypt. The text is
+  // counted in chunks of parallel_chunk_size bytes, a stop is noticed between them.
+  static CrackResult crack(const std::string &text, const std::stop_token &stop_token = {}) {
+    CaesarCracker cracker;
+    for (std::size_t offset {}; offset < text.size(); offset += parallel_chunk_size) {
+      throw_if_stop_requested(stop_token);
+      cracker.update(std::string_view { text }.substr(offset, parallel_chunk_size));
+    }
+    const auto shift { cracker.rank()[0].shift };
+    throw_if_stop_requested(stop_token);
+    return { std::to_string(shift), CaesarCryptoStrategy {}.decrypt(text, std::any { shift }) };
+  }
+
+ private:
+  unsigned threads;
+  LetterHistogram::Counts counts {};
+};
+
+#endif
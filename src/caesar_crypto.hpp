@@ -1,82 +1,135 @@
 #ifndef CAESAR_CRYPTO_HPP
 #define CAESAR_CRYPTO_HPP
 
-#include <cctype>
 #include <functional>
-#include <stdexcept>
 
+#include "caesar_kernel.hpp"
 #include "crypto_strategy.hpp"
 #include "errors.hpp"
 
+class CaesarCryptoStream : public CryptoStream {
+ public:
+  explicit CaesarCryptoStream(std::function<std::string(const std::string &, int)> transform)
+      : transform { std::move(transform) } {}
+
+  void begin(const std::any &any) override { shift = std::any_cast<int>(any); }
+
+  std::string update(const std::string &chunk) override { return transform(chunk, shift); }
+
+  std::string finish() override { return {}; }
+
+ private:
+  std::function<std::string(const std::string &, int)> transform;
+  int shift {};
+};
+
+class CaesarKey : public PreparedKey {
+ public:
+  explicit CaesarKey(int shift) noexcept
+      : encryption { CaesarKernel::for_encryption(shift) }, decryption { CaesarKernel::for_decryption(shift) } {}
+
+  CaesarKernel encryption;
+  CaesarKernel decryption;
+};
+
 class CaesarCryptoStrategy : public CryptoStrategy {
  public:
   std::string encrypt(const std::string &text_for_encoding, const std::any &any) override {
-    return parse(text_for_encoding, std::any_cast<int>(any),
-                 [this](auto ch, auto shift) { return encrypt_char(ch, shift); });
+    return parse(text_for_encoding, CaesarKernel::for_encryption(std::any_cast<int>(any)));
   }
 
   std::string decrypt(const std::string &text_for_decoding, const std::any &any) override {
-    return parse(text_for_decoding, std::any_cast<int>(any),
-                 [this](auto ch, auto shift) { return decrypt_char(ch, shift); });
+    return parse(text_for_decoding, CaesarKernel::for_decryption(std::any_cast<int>(any)));
   }
 
-  bool is_key_numeric() noexcept override { return true; }
+  std::unique_ptr<PreparedKey> prepare_key(const char *key) override {
+    return std::make_unique<CaesarKey>(std::stoi(key));
+  }
 
- private:
-  std::string parse(const std::string &text, int shift, std::function<char(char, int)> policy) {
-    std::string result;
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    return parse(text_for_encoding, key_cast<CaesarKey>(key).encryption);
+  }
 
-    for (auto &&ch : text) {
-      result += parse_character(ch, shift, policy);
-    }
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    return parse(text_for_decoding, key_cast<CaesarKey>(key).decryption);
+  }
 
-    return result;
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_encrypt_into(in, out, key));
+  }
+
+  std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_decrypt_into(in, out, key));
   }
 
-  char parse_character(char ch, int shift, std::function<char(char, int)> policy) {
-    if (std::ispunct(ch) || std::isspace(ch)) {
-      return ch;
-    } else {
-      return policy(ch, shift);
+  SizeOrError try_encrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const auto *caesar_key { try_key_cast<CaesarKey>(key) };
+    if (caesar_key == nullptr) {
+      return std::unexpected { foreign_key_error };
     }
+
+    return try_transform(in, out, caesar_key->encryption);
   }
 
-  char encrypt_char(char ch, int shift) {
-    auto encrypted { ch + shift % 26 };
-    if (ch >= 'a' && ch <= 'z') {
-      return check_encrypt_boundary_lower_case(encrypted);
-    } else if (ch >= 'A' && ch <= 'Z') {
-      return check_encrypt_boundary_upper_case(encrypted);
-    } else {
-      throw_exception(broken_text_error);
+  SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const auto *caesar_key { try_key_cast<CaesarKey>(key) };
+    if (caesar_key == nullptr) {
+      return std::unexpected { foreign_key_error };
     }
+
+    return try_transform(in, out, caesar_key->decryption);
+  }
+
+  // The kernels allow in and out to alias. On error the text is left partially transformed.
+  void encrypt_in_place(std::span<std::byte> text, const PreparedKey &key) {
+    transform(text.data(), text.data(), text.size(), key_cast<CaesarKey>(key).encryption);
+  }
+
+  void decrypt_in_place(std::span<std::byte> text, const PreparedKey &key) {
+    transform(text.data(), text.data(), text.size(), key_cast<CaesarKey>(key).decryption);
+  }
+
+  bool is_key_numeric() noexcept override { return true; }
+
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override { return text_size; }
+
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override { return text_size; }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<CaesarCryptoStream>([this](auto &&chunk, auto shift) { return encrypt(chunk, shift); });
   }
 
-  char check_encrypt_boundary_lower_case(unsigned char encrypted) {
-    return encrypted > 'z' ? encrypted - 'z' + 'a' - 1 : encrypted;
+  std::unique_ptr<CryptoStream> create_decryption_stream() override {
+    return std::make_unique<CaesarCryptoStream>([this](auto &&chunk, auto shift) { return decrypt(chunk, shift); });
   }
 
-  char check_encrypt_boundary_upper_case(unsigned char encrypted) {
-    return encrypted > 'Z' ? encrypted - 'Z' + 'A' - 1 : encrypted;
+ private:
+  std::string parse(const std::string &text, const CaesarKernel &kernel) {
+    std::string result(text.size(), '\0');
+    transform(text.data(), result.data(), text.size(), kernel);
+    return result;
   }
 
-  char decrypt_char(char ch, int shift) {
-    auto decrypted { ch - shift % 26 };
-    if (ch >= 'a' && ch <= 'z') {
-      return check_decrypt_boundary_lower_case(decrypted);
-    } else if (ch >= 'A' && ch <= 'Z') {
-      return check_decrypt_boundary_upper_case(decrypted);
-    } else {
+  static void transform(const void *in, void *out, std::size_t size, const CaesarKernel &kernel) {
+    if (kernel.transform(static_cast<const char *>(in), static_cast<char *>(out), size) == false) {
       throw_exception(broken_text_error);
     }
   }
 
-  char check_decrypt_boundary_lower_case(unsigned char decrypted) {
-    return decrypted < 'a' ? decrypted + 'z' - 'a' + 1 : decrypted;
-  }
+  static SizeOrError try_transform(std::span<const std::byte> in, std::span<std::byte> out,
+                                   const CaesarKernel &kernel) noexcept {
+    if (out.size() < in.size()) {
+      return std::unexpected { output_buffer_is_too_small_error };
+    }
+
+    const auto *text { reinterpret_cast<const char *>(in.data()) };
+    if (kernel.transform(text, reinterpret_cast<char *>(out.data()), in.size()) == false) {
+      return std::unexpected { broken_text_error };
+    }
 
-  char check_decrypt_boundary_upper_case(unsigned char decrypted) {
-    return decrypted < 'A' ? decrypted + 'Z' - 'A' + 1 : decrypted;
+    return in.size();
   }
 };
 
@@ -0,0 +1,116 @@
+#ifndef CAESAR_KERNEL_HPP
+#define CAESAR_KERNEL_HPP
+
+#include <cstddef>
+
+#include "char_classes.hpp"
+#include "cpu_features.hpp"
+
+// Shifts letters by `add` and, for non-negative shifts, wraps them around inside their case. The legacy per-char code
+// did not wrap negative shifts, the kernel keeps that so the output stays bit-identical.
+class CaesarKernel {
+ public:
+  static CaesarKernel for_encryption(int shift) noexcept {
+    const auto reduced { shift % 26 };
+    return { reduced, reduced >= 0 };
+  }
+
+  static CaesarKernel for_decryption(int shift) noexcept {
+    const auto reduced { shift % 26 };
+    return reduced >= 0 ? CaesarKernel { (26 - reduced) % 26, true } : CaesarKernel { -reduced, false };
+  }
+
+  // Writes size chars to out, which may alias in. Returns false when the text contains a broken char.
+  bool transform(const char *in, char *out, std::size_t size) const noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    return CpuFeatures::has_avx2() ? transform_avx2(in, out, size) : transform_sse2(in, out, size);
+#else
+    return transform_scalar(in, out, size);
+#endif
+  }
+
+  bool transform_scalar(const char *in, char *out, std::size_t size) const noexcept {
+    for (std::size_t i {}; i < size; ++i) {
+      const auto ch { in[i] };
+      switch (CharClasses::of(ch)) {
+        case CharClasses::BROKEN:
+          return false;
+        case CharClasses::SKIPPED:
+          out[i] = ch;
+          break;
+        case CharClasses::LOWER:
+          out[i] = shift_letter(ch, 'a');
+          break;
+        case CharClasses::UPPER:
+          out[i] = shift_letter(ch, 'A');
+          break;
+      }
+    }
+
+    return true;
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  bool transform_sse2(const char *in, char *out, std::size_t size) const noexcept {
+    std::size_t i {};
+    for (; i + 16 <= size; i += 16) {
+      const auto text { _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)) };
+      const auto lower { SimdBytes::in_range(text, 'a', 'z') };
+      const auto letters { _mm_or_si128(lower, SimdBytes::in_range(text, 'A', 'Z')) };
+      if (_mm_movemask_epi8(SimdBytes::broken(text)) != 0) {
+        return false;
+      }
+
+      auto shifted { _mm_add_epi8(text, _mm_set1_epi8(add)) };
+      if (wraps) {
+        const auto base { _mm_add_epi8(_mm_set1_epi8('A'), _mm_and_si128(lower, _mm_set1_epi8(32))) };
+        const auto offset { _mm_add_epi8(_mm_sub_epi8(text, base), _mm_set1_epi8(add)) };
+        const auto overflow { _mm_cmpgt_epi8(offset, _mm_set1_epi8(25)) };
+        shifted = _mm_sub_epi8(shifted, _mm_and_si128(overflow, _mm_set1_epi8(26)));
+      }
+
+      const auto result { _mm_or_si128(_mm_and_si128(letters, shifted), _mm_andnot_si128(letters, text)) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), result);
+    }
+
+    return transform_scalar(in + i, out + i, size - i);
+  }
+
+  __attribute__((target("avx2"))) bool transform_avx2(const char *in, char *out, std::size_t size) const noexcept {
+    std::size_t i {};
+    for (; i + 32 <= size; i += 32) {
+      const auto text { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)) };
+      const auto lower { SimdBytes::in_range(text, 'a', 'z') };
+      const auto letters { _mm256_or_si256(lower, SimdBytes::in_range(text, 'A', 'Z')) };
+      if (_mm256_movemask_epi8(SimdBytes::broken(text)) != 0) {
+        return false;
+      }
+
+      auto shifted { _mm256_add_epi8(text, _mm256_set1_epi8(add)) };
+      if (wraps) {
+        const auto base { _mm256_add_epi8(_mm256_set1_epi8('A'), _mm256_and_si256(lower, _mm256_set1_epi8(32))) };
+        const auto offset { _mm256_add_epi8(_mm256_sub_epi8(text, base), _mm256_set1_epi8(add)) };
+        const auto overflow { _mm256_cmpgt_epi8(offset, _mm256_set1_epi8(25)) };
+        shifted = _mm256_sub_epi8(shifted, _mm256_and_si256(overflow, _mm256_set1_epi8(26)));
+      }
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_blendv_epi8(text, shifted, letters));
+    }
+
+    return transform_sse2(in + i, out + i, size - i);
+  }
+#endif
+
+ private:
+  CaesarKernel(int add, bool wraps) noexcept : add { static_cast<char>(add) }, wraps { wraps } {}
+
+  char shift_letter(char ch, char base) const noexcept {
+    const auto offset { ch - base + add };
+    return static_cast<char>(ch + add - (wraps && offset > 25 ? 26 : 0));
+  }
+
+  char add;
+  bool wraps;
+};
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef CASCADE_CRYPTO_HPP
+#define CASCADE_CRYPTO_HPP
+
+#include <algorithm>
+#include <any>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "crypto_strategy.hpp"
+#include "errors.hpp"
+
+// The same map as CryptoStrategies, without pulling in the inputs.
+using CascadeStages = std::unordered_map<std::string_view, std::unique_ptr<CryptoStrategy>>;
+
+// The stages of a cascade and their keys, parsed from a key like "vigenere:lemon|caesar:3|aes:hellohellohelloh". The
+// stages run left to right on encryption and right to left on decryption.
+class CascadeKey : public PreparedKey {
+ public:
+  static constexpr std::size_t max_stages_count { 4 };
+  static constexpr char stages_separator { '|' };
+  static constexpr char name_separator { ':' };
+
+  struct Stage {
+    CryptoStrategy *strategy;
+    std::string key;
+
+    // Converted like CryptoInput converts keys, on demand, so the pointer into key stays valid when stages move.
+    std::any get_key() const {
+      return strategy->is_key_numeric() ? std::any { std::stoi(key) } : std::any { key.c_str() };
+    }
+  };
+
+  CascadeKey(const CascadeStages &strategies, std::string_view key) {
+    while (true) {
+      const auto end { std::min(key.find(stages_separator), key.size()) };
+      parse_stage(strategies, key.substr(0, end));
+      if (end == key.size()) {
+        break;
+      }
+      key.remove_prefix(end + 1);
+    }
+
+    if (stages.size() > max_stages_count) {
+      throw_exception(cascade_key_error);
+    }
+  }
+
+  std::vector<Stage> stages;
+
+ private:
+  void parse_stage(const CascadeStages &strategies, std::string_view stage) {
+    const auto separator { stage.find(name_separator) };
+    if (separator == std::string_view::npos) {
+      throw_exception(cascade_key_error);
+    }
+
+    const auto it { strategies.find(stage.substr(0, separator)) };
+    if (it == strategies.end()) {
+      throw_exception(unknown_crypto_strategy_error);
+    }
+
+    stages.push_back({ it->second.get(), std::string { stage.substr(separator + 1) } });
+    // A bad numeric key fails here and not in the middle of the text.
+    static_cast<void>(stages.back().get_key());
+  }
+};
+
+// Feeds every chunk through the streams of all stages before the next one is read, so a chunk stays in the cache from
+// the first stage to the last and the text crosses main memory once, instead of once per stage.
+class CascadeCryptoStream : public CryptoStream {
+ public:
+  CascadeCryptoStream(const CascadeStages &strategies, bool is_encryption)
+      : strategies { strategies }, is_encryption { is_encryption } {}
+
+  void begin(const std::any &any) override {
+    owned_key.emplace(strategies, std::any_cast<const char *>(any));
+    begin(*owned_key);
+  }
+
+  // The key must outlive the stream.
+  void begin(const CascadeKey &key) {
+    streams.clear();
+    for (auto &&stage : key.stages) {
+      auto &strategy { *stage.strategy };
+      streams.push_back(is_encryption ? strategy.create_encryption_stream() : strategy.create_decryption_stream());
+      streams.back()->begin(stage.get_key());
+    }
+
+    if (is_encryption == false) {
+      std::ranges::reverse(streams);
+    }
+  }
+
+  std::string update(const std::string &chunk) override {
+    auto result { streams.front()->update(chunk) };
+    for (auto &&stream : std::span { streams }.subspan(1)) {
+      result = stream->update(result);
+    }
+    return result;
+  }
+
+  // What a stage flushes still goes through the stages after it, before those are flushed themselves.
+  std::string finish() override {
+    std::string result;
+    for (auto &&stream : streams) {
+      if (result.empty() == false) {
+        result = stream->update(result);
+      }
+      result += stream->finish();
+    }
+    return result;
+  }
+
+ private:
+  const CascadeStages &strategies;
+  bool is_encryption;
+  std::optional<CascadeKey> owned_key;
+  std::vector<std::unique_ptr<CryptoStream>> streams;
+};
+
+// Composes other strategies into one, configured by the key alone, see CascadeKey. It owns its stage strategies, so it
+// keeps no per-call state and is safe to share like the others. The text is streamed through the stages in chunks of
+// block_size bytes.
+class CascadeCryptoStrategy : public CryptoStrategy {
+ public:
+  static constexpr std::size_t block_size { 1 << 15 };
+
+  explicit CascadeCryptoStrategy(CascadeStages &&strategies) : strategies { std::move(strategies) } {}
+
+  std::string encrypt(const std::string &text_for_encoding, const std::any &any) override {
+    return encrypt(text_for_encoding, CascadeKey { strategies, std::any_cast<const char *>(any) });
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const std::any &any) override {
+    return decrypt(text_for_decoding, CascadeKey { strategies, std::any_cast<const char *>(any) });
+  }
+
+  std::unique_ptr<PreparedKey> prepare_key(const char *key) override {
+    return std::make_unique<CascadeKey>(strategies, key);
+  }
+
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    std::string result;
+    transform(text_for_encoding, key_cast<CascadeKey>(key), true,
+              [&result](const std::string &part) { result += part; });
+    return result;
+  }
+
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    std::string result;
+    transform(text_for_decoding, key_cast<CascadeKey>(key), false,
+              [&result](const std::string &part) { result += part; });
+    return result;
+  }
+
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    const auto &cascade_key { key_cast<CascadeKey>(key) };
+    check_output_size(out.size(), max_encrypted_size(in.size(), cascade_key));
+    return transform_into(in, out, cascade_key, true);
+  }
+
+  std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    const auto &cascade_key { key_cast<CascadeKey>(key) };
+    check_output_size(out.size(), max_decrypted_size(in.size(), cascade_key));
+    return transform_into(in, out, cascade_key, false);
+  }
+
+  bool is_key_numeric() noexcept override { return false; }
+
+  // The stages aren't known without the key, so the bounds assume the most expanding strategy at every stage.
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override {
+    for (std::size_t stage {}; stage < CascadeKey::max_stages_count; ++stage) {
+      text_size = get_largest(text_size, &CryptoStrategy::max_encrypted_size);
+    }
+    return text_size;
+  }
+
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override {
+    for (std::size_t stage {}; stage < CascadeKey::max_stages_count; ++stage) {
+      text_size = get_largest(text_size, &CryptoStrategy::max_decrypted_size);
+    }
+    return text_size;
+  }
+
+  // With the key the bounds follow its stages, in the order they run.
+  std::size_t max_encrypted_size(std::size_t text_size, const PreparedKey &key) noexcept override {
+    const auto *cascade_key { try_key_cast<CascadeKey>(key) };
+    if (cascade_key == nullptr) {
+      return max_encrypted_size(text_size);
+    }
+
+    for (auto &&stage : cascade_key->stages) {
+      text_size = stage.strategy->max_encrypted_size(text_size);
+    }
+    return text_size;
+  }
+
+  std::size_t max_decrypted_size(std::size_t text_size, const PreparedKey &key) noexcept override {
+    const auto *cascade_key { try_key_cast<CascadeKey>(key) };
+    if (cascade_key == nullptr) {
+      return max_decrypted_size(text_size);
+    }
+
+    for (auto &&stage : std::views::reverse(cascade_key->stages)) {
+      text_size = stage.strategy->max_decrypted_size(text_size);
+    }
+    return text_size;
+  }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<CascadeCryptoStream>(strategies, true);
+  }
+
+  std::unique_ptr<CryptoStream> create_decryption_stream() override {
+    return std::make_unique<CascadeCryptoStream>(strategies, false);
+  }
+
+ private:
+  template <class Write>
+  void transform(std::string_view text, const CascadeKey &key, bool is_encryption, Write write) {
+    CascadeCryptoStream stream { strategies, is_encryption };
+    stream.begin(key);
+
+    std::string block;
+    for (std::size_t offset {}; offset < text.size(); offset += block_size) {
+      block.assign(text.substr(offset, block_size));
+      write(stream.update(block));
+    }
+    write(stream.finish());
+  }
+
+  std::size_t transform_into(std::span<const std::byte> in, std::span<std::byte> out, const CascadeKey &key,
+                             bool is_encryption) {
+    std::size_t size {};
+    const std::string_view text { reinterpret_cast<const char *>(in.data()), in.size() };
+    transform(text, key, is_encryption, [&](const std::string &part) {
+      if (part.size() > out.size() - size) {
+        throw_exception(output_is_too_large_error);
+      }
+
+      std::ranges::copy(std::as_bytes(std::span { part }), out.begin() + size);
+      size += part.size();
+    });
+    return size;
+  }
+
+  std::size_t get_largest(std::size_t text_size, std::size_t (CryptoStrategy::*max_size)(std::size_t)) noexcept {
+    auto result { text_size };
+    for (auto &&[name, strategy] : strategies) {
+      result = std::max(result, ((*strategy).*max_size)(text_size));
+    }
+    return result;
+  }
+
+  CascadeStages strategies;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef CHAR_CLASSES_HPP
+#define CHAR_CLASSES_HPP
+
+#include <array>
+
+// Character classes of the "C" locale as seen by std::ispunct/std::isspace, the only characters the ciphers let
+// through unchanged. Everything else that is not a latin letter breaks the text.
+class CharClasses {
+ public:
+  enum Class : unsigned char { BROKEN, SKIPPED, LOWER, UPPER };
+
+  static Class of(char ch) noexcept;
+
+  static bool is_letter(char ch) noexcept { return of(ch) >= LOWER; }
+
+ private:
+  static constexpr std::array<Class, 256> make_table() {
+    std::array<Class, 256> result {};
+    for (auto i { 0 }; i < 256; ++i) {
+      if (i >= 'a' && i <= 'z') {
+        result[i] = LOWER;
+      } else if (i >= 'A' && i <= 'Z') {
+        result[i] = UPPER;
+      } else if ((i >= '\t' && i <= '\r') || (i >= ' ' && i <= '~' && (i < '0' || i > '9'))) {
+        result[i] = SKIPPED;
+      }
+    }
+    return result;
+  }
+
+  static const std::array<Class, 256> table;
+};
+
+inline constexpr std::array<CharClasses::Class, 256> CharClasses::table { CharClasses::make_table() };
+
+inline CharClasses::Class CharClasses::of(char ch) noexcept { return table[static_cast<unsigned char>(ch)]; }
+
+#endif
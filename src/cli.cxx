@@ -0,0 +1,183 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+
+#include "command_line.hpp"
+#include "crackers.hpp"
+#include "crypto_strategies_factory.hpp"
+#include "file_crypto.hpp"
+#include "trace.hpp"
+
+class Cli {
+ public:
+  explicit Cli(const CommandLine &command_line)
+      : command_line { command_line }, input { data_view, make_crypto_strategies(command_line.encoding) } {
+    if (command_line.is_stats_enabled) {
+      input.set_stats(&stats);
+    }
+    Tracer::get_instance().set_enabled(command_line.trace_path.empty() == false);
+  }
+
+  int run() {
+    const auto status { run_mode() };
+    if (command_line.is_stats_enabled) {
+      std::cerr << stats.to_json() << '\n';
+    }
+    if (command_line.trace_path.empty() == false) {
+      write_trace();
+    }
+
+    return status;
+  }
+
+ private:
+  int run_mode() {
+    if (command_line.mode == CommandLine::Mode::CRACK) {
+      return run_crack_mode();
+    }
+
+    return command_line.is_file_mode ? run_file_mode() : run_text_mode();
+  }
+
+  int run_text_mode() {
+    const auto text { read_text() };
+    if (command_line.mode == CommandLine::Mode::ENCRYPTION) {
+      input.encrypt(command_line.crypto_strategy_name, text, command_line.key);
+    } else {
+      input.decrypt(command_line.crypto_strategy_name, text, command_line.key);
+    }
+
+    if (data_view.has_error) {
+      std::cerr << data_view.output_text;
+      return 1;
+    }
+
+    write_text();
+    return 0;
+  }
+
+  // The key is printed to stderr like the reports of the other modes.
+  int run_crack_mode() {
+    try {
+      if (command_line.is_file_mode) {
+        const auto result { Crackers::crack_file(command_line.crypto_strategy_name,
+                                                 std::string { command_line.input_path },
+                                                 std::string { command_line.output_path }) };
+        std::cerr << "key: " << result.key << '\n'
+                  << result.report.bytes_in << " bytes in, " << result.report.seconds << " s\n";
+        return 0;
+      }
+
+      auto result { Crackers::crack(command_line.crypto_strategy_name, read_text()) };
+      std::cerr << "key: " << result.key << '\n';
+      data_view.output_text = std::move(result.plain_text);
+    } catch (const std::exception &e) {
+      std::cerr << e.what();
+      return 1;
+    }
+
+    write_text();
+    return 0;
+  }
+
+  int run_file_mode() {
+    try {
+      const auto report { process_files() };
+      const std::chrono::duration<double> latency { report.seconds };
+      stats.record(command_line.crypto_strategy_name, report.bytes_in, report.bytes_out,
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(latency), false);
+      std::cerr << report.bytes_in << " bytes in, " << report.bytes_out << " bytes out, " << report.seconds << " s, "
+                << report.megabytes_per_second() << " MB/s\n";
+      return 0;
+    } catch (const std::exception &e) {
+      stats.record(command_line.crypto_strategy_name, 0, 0, {}, true);
+      std::cerr << e.what();
+      return 1;
+    }
+  }
+
+  FileCrypto::Report process_files() {
+    auto crypto_strategies { make_crypto_strategies(command_line.encoding) };
+    auto &strategy { *crypto_strategies.at(command_line.crypto_strategy_name) };
+    const std::string input_path { command_line.input_path };
+    const std::string output_path { command_line.output_path };
+
+    if (command_line.mode == CommandLine::Mode::ENCRYPTION) {
+      return FileCrypto::encrypt(strategy, command_line.key, input_path, output_path);
+    } else {
+      return FileCrypto::decrypt(strategy, command_line.key, input_path, output_path);
+    }
+  }
+
+  std::string read_text() {
+    if (CommandLine::is_standard_stream(command_line.input_path)) {
+      return read_all(std::cin);
+    }
+
+    std::ifstream file { std::string { command_line.input_path }, std::ios::binary };
+    if (!file) {
+      throw_exception(cannot_open_file_error);
+    }
+
+    return read_all(file);
+  }
+
+  static std::string read_all(std::istream &in) {
+    return { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+  }
+
+  void write_text() {
+    if (CommandLine::is_standard_stream(command_line.output_path)) {
+      write_all(std::cout, data_view.output_text);
+    } else {
+      std::ofstream file { std::string { command_line.output_path }, std::ios::binary };
+      if (!file) {
+        throw_exception(cannot_open_file_error);
+      }
+
+      write_all(file, data_view.output_text);
+    }
+  }
+
+  void write_trace() {
+    std::ofstream file { std::string { command_line.trace_path }, std::ios::binary };
+    if (!file) {
+      throw_exception(cannot_open_file_error);
+    }
+
+    write_all(file, Tracer::get_instance().to_json());
+  }
+
+  // A full disk or a closed pipe only shows in the stream state after the flush.
+  static void write_all(std::ostream &out, const std::string &text) {
+    if (!out.write(text.data(), static_cast<std::streamsize>(text.size())).flush()) {
+      throw_exception(cannot_write_output_error);
+    }
+  }
+
+  const CommandLine &command_line;
+  CryptoStats stats { crypto_strategies_binds };
+  DataView data_view;
+  CryptoInput input;
+};
+
+int main(int argc, char **argv) {
+  std::ios::sync_with_stdio(false);
+
+  std::optional<CommandLine> command_line;
+  try {
+    command_line.emplace(std::span<const char *const> { argv + 1, argv + argc });
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << CommandLine::usage;
+    return 2;
+  }
+
+  try {
+    return Cli { *command_line }.run();
+  } catch (const std::exception &e) {
+    std::cerr << e.what();
+    return 1;
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef COMMAND_LINE_HPP
+#define COMMAND_LINE_HPP
+
+#include <algorithm>
+#include <span>
+#include <string_view>
+
+#include "crypto_strategies_binds.hpp"
+#include "errors.hpp"
+#include "text_codec.hpp"
+
+class CommandLine {
+ public:
+  enum class Mode { ENCRYPTION, DECRYPTION, CRACK };
+
+  static constexpr auto usage {
+    "Usage: crypto_cli [--stats] [--trace=<file>] [--encoding=<raw|hex|base64>] <strategy> <encrypt|decrypt> <key> "
+    "[input|-] [output|-]\n"
+    "       crypto_cli [--stats] [--trace=<file>] [--encoding=<raw|hex|base64>] --mmap <strategy> <encrypt|decrypt> "
+    "<key> <input> <output>\n"
+    "       crypto_cli <strategy> crack [input|-] [output|-]\n"
+    "       crypto_cli --mmap <strategy> crack <input> <output>\n"
+    "       --stats prints per-strategy counters as JSON to stderr\n"
+    "       --trace writes the stage timings as Chrome trace-event JSON, e.g. for Perfetto\n"
+    "       --encoding sets how aes writes its ciphertext, hex by default, raw is for files only\n"
+    "       cascade takes one key per stage, e.g. \"vigenere:lemon|caesar:3|aes:<16 bytes>\"\n"
+    "       crack recovers the key of a ciphertext of English text, prints it to stderr and decrypts the text\n"
+  };
+
+  explicit CommandLine(std::span<const char *const> args) {
+    while (args.empty() == false && std::string_view { args[0] }.starts_with(flag_prefix)) {
+      parse_flag(args[0]);
+      args = args.subspan(1);
+    }
+
+    if (args.size() < 2) {
+      throw_exception(wrong_arguments_count_error);
+    }
+
+    crypto_strategy_name = parse_crypto_strategy_name(args[0]);
+    mode = parse_mode(args[1]);
+
+    // A crack takes no key.
+    const std::size_t keys_count { mode == Mode::CRACK ? 0u : 1u };
+    if (args.size() < 2 + keys_count || args.size() > 4 + keys_count) {
+      throw_exception(wrong_arguments_count_error);
+    }
+
+    key = keys_count == 0 ? nullptr : args[2];
+    const auto paths { args.subspan(2 + keys_count) };
+    input_path = paths.size() > 0 ? paths[0] : standard_stream;
+    output_path = paths.size() > 1 ? paths[1] : standard_stream;
+
+    if (is_file_mode && (is_standard_stream(input_path) || is_standard_stream(output_path))) {
+      throw_exception(file_mode_needs_paths_error);
+    }
+  }
+
+  static bool is_standard_stream(std::string_view path) noexcept { return path == standard_stream; }
+
+  std::string_view crypto_strategy_name;
+  Mode mode;
+  // Null for a crack.
+  const char *key;
+  std::string_view input_path;
+  std::string_view output_path;
+  bool is_file_mode {};
+  bool is_stats_enabled {};
+  std::string_view trace_path;
+  // Of the aes ciphertext.
+  TextEncoding encoding { TextEncoding::HEX };
+
+ private:
+  static constexpr std::string_view standard_stream { "-" };
+  static constexpr std::string_view flag_prefix { "--" };
+  static constexpr std::string_view file_mode_flag { "--mmap" };
+  static constexpr std::string_view stats_flag { "--stats" };
+  static constexpr std::string_view trace_flag { "--trace=" };
+  static constexpr std::string_view encoding_flag { "--encoding=" };
+
+  void parse_flag(std::string_view flag) {
+    if (flag == file_mode_flag) {
+      is_file_mode = true;
+    } else if (flag == stats_flag) {
+      is_stats_enabled = true;
+    } else if (flag.starts_with(trace_flag)) {
+      trace_path = flag.substr(trace_flag.size());
+      if (trace_path.empty()) {
+        throw_exception(trace_needs_path_error);
+      }
+    } else if (flag.starts_with(encoding_flag)) {
+      const auto parsed { TextCodec::parse(flag.substr(encoding_flag.size())) };
+      if (parsed.has_value() == false) {
+        throw_exception(unknown_encoding_error);
+      }
+      encoding = *parsed;
+    } else {
+      throw_exception(unknown_flag_error);
+    }
+  }
+
+  std::string_view parse_crypto_strategy_name(std::string_view name) {
+    const auto it { std::ranges::find(crypto_strategies_binds, name) };
+    if (it == crypto_strategies_binds.end()) {
+      throw_exception(unknown_crypto_strategy_error);
+    }
+
+    return *it;
+  }
+
+  Mode parse_mode(std::string_view name) {
+    if (name == "encrypt") {
+      return Mode::ENCRYPTION;
+    } else if (name == "decrypt") {
+      return Mode::DECRYPTION;
+    } else if (name == "crack") {
+      return Mode::CRACK;
+    } else {
+      throw_exception(unknown_crypto_mode_error);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CRYPTO_X86_KERNELS 1
+#endif
+
+class CpuFeatures {
+ public:
+#ifdef CRYPTO_X86_KERNELS
+  static bool has_ssse3() noexcept {
+    static const auto result { __builtin_cpu_supports("ssse3") > 0 };
+    return result;
+  }
+
+  static bool has_avx2() noexcept {
+    static const auto result { __builtin_cpu_supports("avx2") > 0 };
+    return result;
+  }
+
+  static bool has_aes_ni() noexcept {
+    static const auto result { __builtin_cpu_supports("aes") > 0 };
+    return result;
+  }
+
+  // The AES rounds on two blocks per 256-bit register.
+  static bool has_vaes() noexcept {
+    static const auto result { __builtin_cpu_supports("vaes") > 0 && has_avx2() };
+    return result;
+  }
+#else
+  static bool has_ssse3() noexcept { return false; }
+
+  static bool has_avx2() noexcept { return false; }
+
+  static bool has_aes_ni() noexcept { return false; }
+
+  static bool has_vaes() noexcept { return false; }
+#endif
+};
+
+#ifdef CRYPTO_X86_KERNELS
+class SimdBytes {
+ public:
+  // Signed compares, so bytes above 0x7F are never in range.
+  static __m128i in_range(__m128i bytes, char low, char high) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(low - 1)),
+                         _mm_cmplt_epi8(bytes, _mm_set1_epi8(high + 1)));
+  }
+
+  __attribute__((target("avx2"))) static __m256i in_range(__m256i bytes, char low, char high) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(low - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), bytes));
+  }
+
+  // Vector form of CharClasses::BROKEN: neither printable nor white space, or a digit.
+  static __m128i broken(__m128i bytes) noexcept {
+    const auto printable { _mm_or_si128(in_range(bytes, ' ', '~'), in_range(bytes, '\t', '\r')) };
+    return _mm_or_si128(_mm_andnot_si128(printable, _mm_set1_epi8(-1)), in_range(bytes, '0', '9'));
+  }
+
+  __attribute__((target("avx2"))) static __m256i broken(__m256i bytes) noexcept {
+    const auto printable { _mm256_or_si256(in_range(bytes, ' ', '~'), in_range(bytes, '\t', '\r')) };
+    return _mm256_or_si256(_mm256_andnot_si256(printable, _mm256_set1_epi8(-1)), in_range(bytes, '0', '9'));
+  }
+};
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef CRACK_RESULT_HPP
+#define CRACK_RESULT_HPP
+
+#include <stop_token>
+#include <string>
+
+#include "errors.hpp"
+
+// A key recovered from the ciphertext alone and the text decrypted with it.
+struct CrackResult {
+  std::string key;
+  std::string plain_text;
+};
+
+// The crackers check for a stop between their steps and throw operation_is_cancelled_error.
+inline void throw_if_stop_requested(const std::stop_token &stop_token) {
+  if (stop_token.stop_requested()) {
+    throw_exception(operation_is_cancelled_error);
+  }
+}
+
+#endif
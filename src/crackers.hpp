@@ -0,0 +1,72 @@
+#ifndef CRACKERS_HPP
+#define CRACKERS_HPP
+
+#include <string>
+#include <stop_token>
+#include <string_view>
+
+#include "caesar_cracker.hpp"
+#include "crack_result.hpp"
+#include "errors.hpp"
+#include "file_crypto.hpp"
+#include "mapped_file.hpp"
+#include "vigenere_cracker.hpp"
+
+// Picks the cracker of a strategy by its name in crypto_strategies_binds.
+class Crackers {
+ public:
+  struct FileResult {
+    std::string key;
+    FileCrypto::Report report;
+  };
+
+  static bool is_supported(std::string_view crypto_strategy_name) noexcept {
+    return crypto_strategy_name == "caesar" || crypto_strategy_name == "vigenere";
+  }
+
+  // Throws crack_is_not_supported_error for the strategies without a cracker, and operation_is_cancelled_error when
+  // a stop is requested.
+  static CrackResult crack(std::string_view crypto_strategy_name, const std::string &text,
+                           const std::stop_token &stop_token = {}) {
+    if (crypto_strategy_name == "caesar") {
+      return CaesarCracker::crack(text, stop_token);
+    } else if (crypto_strategy_name == "vigenere") {
+      return VigenereCracker {}.crack(text, stop_token);
+    }
+
+    throw_exception(crack_is_not_supported_error);
+  }
+
+  // The key is found in a mapping of the input, then FileCrypto decrypts the file with it, so the text is never held
+  // in a std::string. The Caesar histogram streams over the mapping, which suits inputs of many GB, while the
+  // Vigenère cracker still copies the letters of the input.
+  static FileResult crack_file(std::string_view crypto_strategy_name, const std::string &input_path,
+                               const std::string &output_path) {
+    if (crypto_strategy_name == "caesar") {
+      const auto key { std::to_string(find_shift(input_path)) };
+      CaesarCryptoStrategy strategy;
+      return { key, FileCrypto::decrypt(strategy, key.c_str(), input_path, output_path) };
+    } else if (crypto_strategy_name == "vigenere") {
+      const auto key { find_vigenere_key(input_path) };
+      VigenereCryptoStrategy strategy;
+      return { key, FileCrypto::decrypt(strategy, key.c_str(), input_path, output_path) };
+    }
+
+    throw_exception(crack_is_not_supported_error);
+  }
+
+ private:
+  static int find_shift(const std::string &input_path) {
+    MappedFile input { input_path, MappedFile::Access::READ };
+    CaesarCracker cracker;
+    cracker.update({ input.data().data(), input.data().size() });
+    return cracker.rank()[0].shift;
+  }
+
+  static std::string find_vigenere_key(const std::string &input_path) {
+    MappedFile input { input_path, MappedFile::Access::READ };
+    return VigenereCracker {}.find_key({ input.data().data(), input.data().size() });
+  }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "crypto_core.h"
+
+#include <optional>
+#include <span>
+
+#include "crypto_strategies_factory.hpp"
+
+struct crypto_context {
+  CryptoStrategies crypto_strategies;
+};
+
+struct crypto_key {
+  CryptoStrategy &strategy;
+  std::unique_ptr<PreparedKey> prepared_key;
+};
+
+namespace {
+
+// No exception may leave through the C interface, the non-throwing strategy calls need no catch.
+const char *process_into(crypto_key &key, const void *in, std::size_t in_size, void *out, std::size_t out_capacity,
+                         std::size_t &out_size, bool is_encryption) noexcept {
+  auto &strategy { key.strategy };
+  const auto &prepared_key { *key.prepared_key };
+  const auto max_size { is_encryption ? strategy.max_encrypted_size(in_size, prepared_key)
+                                      : strategy.max_decrypted_size(in_size, prepared_key) };
+  if (out_capacity < max_size) {
+    return output_buffer_is_too_small_error;
+  }
+
+  const std::span input { static_cast<const std::byte *>(in), in_size };
+  const std::span output { static_cast<std::byte *>(out), max_size };
+  const auto size { is_encryption ? strategy.try_encrypt_into(input, output, prepared_key)
+                                  : strategy.try_decrypt_into(input, output, prepared_key) };
+  if (size.has_value() == false) {
+    return size.error();
+  }
+
+  out_size = *size;
+  return nullptr;
+}
+
+}  // namespace
+
+extern "C" {
+
+int crypto_core_abi_version(void) { return CRYPTO_CORE_ABI_VERSION; }
+
+const char *crypto_context_create(const char *encoding, crypto_context **context) {
+  const auto parsed { encoding == nullptr ? std::optional { TextEncoding::HEX } : TextCodec::parse(encoding) };
+  if (parsed.has_value() == false) {
+    return unknown_encoding_error;
+  }
+
+  try {
+    *context = new crypto_context { make_crypto_strategies(*parsed) };
+  } catch (...) {
+    return operation_failed_error;
+  }
+  return nullptr;
+}
+
+void crypto_context_free(crypto_context *context) { delete context; }
+
+// The errors other than CryptoError come from parsing and from Crypto++, their messages are not static.
+const char *crypto_prepare_key(crypto_context *context, const char *strategy, const char *key,
+                               crypto_key **prepared_key) {
+  const auto it { context->crypto_strategies.find(strategy) };
+  if (it == context->crypto_strategies.end()) {
+    return unknown_crypto_strategy_error;
+  }
+
+  try {
+    *prepared_key = new crypto_key { *it->second, it->second->prepare_key(key) };
+  } catch (const CryptoError &e) {
+    return e.get_error();
+  } catch (...) {
+    return invalid_key_error;
+  }
+  return nullptr;
+}
+
+void crypto_key_free(crypto_key *key) { delete key; }
+
+size_t crypto_max_encrypted_size(const crypto_key *key, size_t size) {
+  return key->strategy.max_encrypted_size(size, *key->prepared_key);
+}
+
+size_t crypto_max_decrypted_size(const crypto_key *key, size_t size) {
+  return key->strategy.max_decrypted_size(size, *key->prepared_key);
+}
+
+const char *crypto_encrypt_into(crypto_key *key, const void *in, size_t in_size, void *out, size_t out_capacity,
+                                size_t *out_size) {
+  return process_into(*key, in, in_size, out, out_capacity, *out_size, true);
+}
+
+const char *crypto_decrypt_into(crypto_key *key, const void *in, size_t in_size, void *out, size_t out_capacity,
+                                size_t *out_size) {
+  return process_into(*key, in, in_size, out, out_capacity, *out_size, false);
+}
+}  // extern "C"
@@ -0,0 +1,61 @@
+#ifndef CRYPTO_CORE_H
+#define CRYPTO_CORE_H
+
+#include <stddef.h>
+
+// The C interface of the crypto_core library, for calling the strategies in-process from C and from anything that
+// loads C libraries. Functions that can fail return null on success and otherwise a message with static storage,
+// one of the errors of errors.hpp. Compare the messages, the library has its own copies of the constants. Only these
+// functions are exported, the C++ headers stay free to change.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define CRYPTO_CORE_API __attribute__((visibility("default")))
+#else
+#define CRYPTO_CORE_API
+#endif
+
+// Bumped whenever a declaration below changes incompatibly.
+#define CRYPTO_CORE_ABI_VERSION 1
+
+typedef struct crypto_context crypto_context;
+typedef struct crypto_key crypto_key;
+
+CRYPTO_CORE_API int crypto_core_abi_version(void);
+
+// Holds every strategy of crypto_strategies_binds. encoding is raw, hex or base64 and sets how aes writes its
+// ciphertext, null is hex. A context can be shared by any number of threads.
+CRYPTO_CORE_API const char *crypto_context_create(const char *encoding, crypto_context **context);
+
+// Every key of the context must be freed first. Null is ignored.
+CRYPTO_CORE_API void crypto_context_free(crypto_context *context);
+
+// Parses and checks the key once for any number of calls, e.g. strategy "caesar" with key "3". A key can hold cipher
+// state, so it belongs to one thread at a time.
+CRYPTO_CORE_API const char *crypto_prepare_key(crypto_context *context, const char *strategy, const char *key,
+                                               crypto_key **prepared_key);
+
+// Null is ignored.
+CRYPTO_CORE_API void crypto_key_free(crypto_key *key);
+
+// The output buffer sizes that are always large enough for an input of size bytes.
+CRYPTO_CORE_API size_t crypto_max_encrypted_size(const crypto_key *key, size_t size);
+
+CRYPTO_CORE_API size_t crypto_max_decrypted_size(const crypto_key *key, size_t size);
+
+// Writes the result straight into the caller's buffer of out_capacity bytes and its size to *out_size, no copy is made
+// on the way. in and out must not overlap.
+CRYPTO_CORE_API const char *crypto_encrypt_into(crypto_key *key, const void *in, size_t in_size, void *out,
+                                                size_t out_capacity, size_t *out_size);
+
+CRYPTO_CORE_API const char *crypto_decrypt_into(crypto_key *key, const void *in, size_t in_size, void *out,
+                                                size_t out_capacity, size_t *out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,465 @@
+#ifndef CRYPTO_DAEMON_HPP
+#define CRYPTO_DAEMON_HPP
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aes_batch_crypto.hpp"
+#include "batch_crypto.hpp"
+#include "crypto_strategies_factory.hpp"
+#include "daemon_protocol.hpp"
+
+// Serves the strategies to the processes of this machine over a Unix domain socket, in the frames of
+// daemon_protocol.hpp. One thread runs an epoll loop over all connections. Every round it reads whatever has arrived,
+// groups the requests by key handle and mode, runs each group as one batch on the workers of its strategy and queues
+// the responses. What comes in while a round runs waits in the socket buffers for the next one, so the batches grow
+// with the load. The same key of a strategy always gets the same handle, so the requests of all connections that
+// registered it form one batch, but a connection can only use the handles it registered. A key is kept while a
+// connection that registered it is open, so the keys are bounded by the open connections.
+class CryptoDaemon {
+ public:
+  static constexpr std::size_t max_keys_per_connection { 1 << 10 };
+  static constexpr std::size_t max_key_size { 1 << 12 };
+  // Only the user of the daemon connects, whatever the umask. Set before listen, so no connection comes in earlier.
+  static constexpr mode_t socket_mode { 0600 };
+
+  CryptoDaemon(const std::string &socket_path, TextEncoding encoding = TextEncoding::HEX,
+               unsigned threads = std::thread::hardware_concurrency())
+      : socket_path { socket_path },
+        encoding { encoding },
+        threads { threads },
+        crypto_strategies { make_crypto_strategies(encoding) } {
+    open_descriptors();
+  }
+
+  CryptoDaemon(const CryptoDaemon &) = delete;
+  CryptoDaemon &operator=(const CryptoDaemon &) = delete;
+
+  ~CryptoDaemon() {
+    for (auto &&[descriptor, connection] : connections) {
+      ::close(descriptor);
+    }
+    close_descriptors();
+  }
+
+  // Serves until stop is called.
+  void run() {
+    std::array<epoll_event, max_events_count> events;
+    while (is_stopped == false) {
+      const auto count { ::epoll_wait(epoll, events.data(), events.size(), -1) };
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw_exception(operation_failed_error);
+      }
+
+      Groups groups;
+      for (int index {}; index < count; ++index) {
+        const auto descriptor { events[index].data.fd };
+        if (descriptor == stop_event) {
+          is_stopped = true;
+        } else if (descriptor == listener) {
+          accept_connections();
+        } else {
+          serve(descriptor, events[index].events, groups);
+        }
+      }
+
+      run_groups(groups);
+      flush_connections();
+    }
+  }
+
+  // From any thread or a signal handler.
+  void stop() noexcept {
+    const std::uint64_t one { 1 };
+    static_cast<void>(::write(stop_event, &one, sizeof(one)));
+  }
+
+ private:
+  static constexpr int max_events_count { 64 };
+  static constexpr std::size_t read_size { 1 << 16 };
+  // Per connection and round, so that one busy peer does not hold up the others. The rest is read next round.
+  static constexpr std::size_t max_round_read_size { 1 << 20 };
+  // A peer that sends more than it reads back is not read from until its responses are down to this.
+  static constexpr std::size_t max_pending_output_size { 1 << 24 };
+
+  struct Connection {
+    std::string input;
+    std::string output;
+    // The handles of the keys this connection registered, each one counted once.
+    std::vector<std::uint32_t> key_handles;
+    std::uint32_t events { EPOLLIN };
+    // The peer has shut down its side but may still wait for the responses.
+    bool is_input_done {};
+    // Closed only once the round is over, so that its descriptor is not reused by a connection accepted meanwhile.
+    bool is_closed {};
+  };
+
+  struct Key {
+    std::uint8_t strategy;
+    std::string value;
+    // The open connections that registered the key.
+    std::size_t connections_count {};
+  };
+
+  struct Group {
+    RecordBatch records;
+    // The connection and request id of every record.
+    std::vector<std::pair<int, std::uint32_t>> origins;
+  };
+
+  using Groups = std::map<std::pair<std::uint32_t, DaemonMode>, Group>;
+
+  void open_descriptors() {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+      throw_exception(cannot_listen_error);
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    stop_event = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (listener < 0 || epoll < 0 || stop_event < 0 || remove_stale_socket(address) == false) {
+      close_descriptors();
+      throw_exception(cannot_listen_error);
+    }
+
+    is_bound = ::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+    if (is_bound == false || ::chmod(socket_path.c_str(), socket_mode) != 0 || ::listen(listener, SOMAXCONN) != 0 ||
+        watch(listener, EPOLLIN) == false || watch(stop_event, EPOLLIN) == false) {
+      close_descriptors();
+      throw_exception(cannot_listen_error);
+    }
+  }
+
+  // Removes a socket left behind by a daemon that did not shut down. False when the path is taken by anything else: a
+  // file that is not a socket or the socket of a daemon that still runs.
+  bool remove_stale_socket(const sockaddr_un &address) const noexcept {
+    struct stat status;
+    if (::lstat(socket_path.c_str(), &status) != 0) {
+      return errno == ENOENT;
+    }
+    if (S_ISSOCK(status.st_mode) == false) {
+      return false;
+    }
+
+    const auto descriptor { ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) };
+    if (descriptor < 0) {
+      return false;
+    }
+    const auto is_stale { ::connect(descriptor, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 &&
+                          errno == ECONNREFUSED };
+    ::close(descriptor);
+    return is_stale && ::unlink(socket_path.c_str()) == 0;
+  }
+
+  void close_descriptors() noexcept {
+    for (auto &&descriptor : { listener, epoll, stop_event }) {
+      if (descriptor >= 0) {
+        ::close(descriptor);
+      }
+    }
+    // The path is another daemon's or another file's until this one has bound it.
+    if (is_bound) {
+      ::unlink(socket_path.c_str());
+    }
+  }
+
+  bool watch(int descriptor, std::uint32_t events) noexcept {
+    epoll_event event { .events = events, .data = { .fd = descriptor } };
+    return ::epoll_ctl(epoll, EPOLL_CTL_ADD, descriptor, &event) == 0;
+  }
+
+  void accept_connections() {
+    while (true) {
+      const auto descriptor { ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC) };
+      if (descriptor < 0) {
+        return;
+      }
+
+      if (watch(descriptor, EPOLLIN) == false) {
+        ::close(descriptor);
+        continue;
+      }
+      connections.try_emplace(descriptor);
+    }
+  }
+
+  void serve(int descriptor, std::uint32_t events, Groups &groups) {
+    const auto it { connections.find(descriptor) };
+    if (it == connections.end()) {
+      return;
+    }
+
+    auto &connection { it->second };
+    if ((events & EPOLLOUT) != 0) {
+      write_output(connection, descriptor);
+    }
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0 && connection.is_closed == false &&
+        connection.is_input_done == false) {
+      read_input(connection, descriptor);
+      take_requests(connection, descriptor, groups);
+    }
+  }
+
+  void read_input(Connection &connection, int descriptor) {
+    for (std::size_t round_read_size {}; round_read_size < max_round_read_size;) {
+      const auto size { connection.input.size() };
+      connection.input.resize(size + read_size);
+      const auto count { ::read(descriptor, connection.input.data() + size, read_size) };
+      connection.input.resize(size + static_cast<std::size_t>(std::max<ssize_t>(count, 0)));
+      if (count > 0) {
+        round_read_size += count;
+        continue;
+      }
+
+      if (count == 0) {
+        connection.is_input_done = true;
+      } else if (errno == EINTR) {
+        continue;
+      } else if (errno != EAGAIN) {
+        connection.is_closed = true;
+      }
+      return;
+    }
+  }
+
+  // Answers what needs no batch right away and sorts the rest into the groups.
+  void take_requests(Connection &connection, int descriptor, Groups &groups) {
+    std::string_view input { connection.input };
+    while (true) {
+      if (DaemonFrames::is_oversized(input)) {
+        connection.is_closed = true;
+        break;
+      }
+
+      const auto request { DaemonFrames::parse_request(input) };
+      if (request.has_value() == false) {
+        break;
+      }
+      input.remove_prefix(DaemonFrames::get_frame_size(*request));
+
+      if (request->strategy >= crypto_strategies_binds.size()) {
+        respond_error(connection, request->id, unknown_crypto_strategy_error);
+      } else if (request->mode == DaemonMode::REGISTER_KEY) {
+        register_key(connection, *request);
+      } else if (request->mode != DaemonMode::ENCRYPTION && request->mode != DaemonMode::DECRYPTION) {
+        respond_error(connection, request->id, unknown_crypto_mode_error);
+      } else if (is_key_of(connection, request->key_handle, request->strategy) == false) {
+        respond_error(connection, request->id, unknown_key_handle_error);
+      } else {
+        auto &group { groups[{ request->key_handle, request->mode }] };
+        group.records.push_back(request->payload);
+        group.origins.emplace_back(descriptor, request->id);
+      }
+    }
+    connection.input.erase(0, connection.input.size() - input.size());
+  }
+
+  // The key is prepared once here only to check it, the batches prepare their own.
+  void register_key(Connection &connection, const DaemonRequest &request) {
+    const std::pair<std::uint8_t, std::string> key { request.strategy, request.payload };
+    if (const auto it { key_handles.find(key) }; it != key_handles.end()) {
+      if (hold_key(connection, it->second)) {
+        respond(connection, { .id = request.id, .payload = DaemonFrames::encode_key_handle(it->second) });
+      } else {
+        respond_error(connection, request.id, too_many_keys_error);
+      }
+      return;
+    }
+
+    if (connection.key_handles.size() == max_keys_per_connection) {
+      respond_error(connection, request.id, too_many_keys_error);
+      return;
+    }
+    if (key.second.size() > max_key_size) {
+      respond_error(connection, request.id, invalid_key_error);
+      return;
+    }
+
+    try {
+      get_strategy(request.strategy).prepare_key(key.second.c_str());
+    } catch (const CryptoError &e) {
+      respond_error(connection, request.id, e.get_error());
+      return;
+    } catch (const std::exception &e) {
+      respond_error(connection, request.id, e.what());
+      return;
+    }
+
+    const auto key_handle { next_key_handle++ };
+    keys.emplace(key_handle, Key { .strategy = request.strategy, .value = key.second });
+    key_handles.emplace(key, key_handle);
+    hold_key(connection, key_handle);
+    respond(connection, { .id = request.id, .payload = DaemonFrames::encode_key_handle(key_handle) });
+  }
+
+  // A connection only uses the keys it registered itself, a handle of another connection is unknown to it.
+  bool is_key_of(const Connection &connection, std::uint32_t key_handle, std::uint8_t strategy) const {
+    const auto it { keys.find(key_handle) };
+    return it != keys.end() && it->second.strategy == strategy &&
+           std::ranges::find(connection.key_handles, key_handle) != connection.key_handles.end();
+  }
+
+  // False when the connection holds too many keys already.
+  bool hold_key(Connection &connection, std::uint32_t key_handle) {
+    if (std::ranges::find(connection.key_handles, key_handle) != connection.key_handles.end()) {
+      return true;
+    }
+    if (connection.key_handles.size() == max_keys_per_connection) {
+      return false;
+    }
+
+    connection.key_handles.push_back(key_handle);
+    ++keys.at(key_handle).connections_count;
+    return true;
+  }
+
+  // Once the round is over, so that no group refers to a released key.
+  void release_keys(const Connection &connection) {
+    for (auto &&key_handle : connection.key_handles) {
+      const auto it { keys.find(key_handle) };
+      if (--it->second.connections_count == 0) {
+        key_handles.erase({ it->second.strategy, it->second.value });
+        keys.erase(it);
+      }
+    }
+  }
+
+  void run_groups(const Groups &groups) {
+    for (auto &&[group_key, group] : groups) {
+      const auto &[key_handle, mode] { group_key };
+      const auto result { process(group.records, keys.at(key_handle), mode == DaemonMode::ENCRYPTION) };
+      for (std::size_t index {}; index < group.origins.size(); ++index) {
+        const auto &[descriptor, id] { group.origins[index] };
+        auto &connection { connections.at(descriptor) };
+        if (result.errors[index] != nullptr) {
+          respond_error(connection, id, result.errors[index]);
+        } else {
+          respond(connection, { .id = id, .payload = result.records[index] });
+        }
+      }
+    }
+  }
+
+  // aes has a batch engine of its own that interleaves the records. The engines start their workers on first use.
+  BatchResult process(const RecordBatch &records, const Key &key, bool is_encryption) {
+    try {
+      if (crypto_strategies_binds[key.strategy] == "aes") {
+        if (aes_batch_crypto == nullptr) {
+          aes_batch_crypto = std::make_unique<AESBatchCrypto>(encoding, threads);
+        }
+        return is_encryption ? aes_batch_crypto->encrypt(records, key.value.c_str())
+                             : aes_batch_crypto->decrypt(records, key.value.c_str());
+      }
+
+      auto &batch_crypto { batch_cryptos[key.strategy] };
+      if (batch_crypto == nullptr) {
+        batch_crypto = std::make_unique<BatchCrypto>(get_strategy(key.strategy), threads);
+      }
+      return is_encryption ? batch_crypto->encrypt(records, key.value.c_str())
+                           : batch_crypto->decrypt(records, key.value.c_str());
+    } catch (const CryptoError &e) {
+      BatchResult result;
+      result.records.offsets.resize(records.size() + 1);
+      result.errors.assign(records.size(), e.get_error());
+      return result;
+    }
+  }
+
+  CryptoStrategy &get_strategy(std::uint8_t strategy) const {
+    return *crypto_strategies.at(crypto_strategies_binds[strategy]);
+  }
+
+  void respond(Connection &connection, const DaemonResponse &response) {
+    if (connection.is_closed == false) {
+      DaemonFrames::append(connection.output, response);
+    }
+  }
+
+  void respond_error(Connection &connection, std::uint32_t id, const char *error) {
+    respond(connection, { .id = id, .is_error = true, .payload = error });
+  }
+
+  // Writes what the round queued, waits for the sockets that are full, and closes the connections that are gone.
+  void flush_connections() {
+    for (auto it { connections.begin() }; it != connections.end();) {
+      auto &[descriptor, connection] { *it };
+      if (connection.is_closed == false && connection.output.empty() == false) {
+        write_output(connection, descriptor);
+      }
+
+      if (connection.is_closed || (connection.is_input_done && connection.output.empty())) {
+        release_keys(connection);
+        ::close(descriptor);
+        it = connections.erase(it);
+        continue;
+      }
+
+      const auto is_reading { connection.is_input_done == false &&
+                              connection.output.size() < max_pending_output_size };
+      const std::uint32_t events { (is_reading ? EPOLLIN : 0u) | (connection.output.empty() ? 0u : EPOLLOUT) };
+      if (events != connection.events) {
+        epoll_event event { .events = events, .data = { .fd = descriptor } };
+        ::epoll_ctl(epoll, EPOLL_CTL_MOD, descriptor, &event);
+        connection.events = events;
+      }
+      ++it;
+    }
+  }
+
+  void write_output(Connection &connection, int descriptor) {
+    std::size_t written {};
+    while (written < connection.output.size()) {
+      const auto count { ::send(descriptor, connection.output.data() + written, connection.output.size() - written,
+                                MSG_NOSIGNAL) };
+      if (count < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+          connection.is_closed = true;
+        }
+        if (errno != EINTR) {
+          break;
+        }
+        continue;
+      }
+      written += count;
+    }
+    connection.output.erase(0, written);
+  }
+
+  std::string socket_path;
+  TextEncoding encoding;
+  unsigned threads;
+  CryptoStrategies crypto_strategies;
+  std::array<std::unique_ptr<BatchCrypto>, crypto_strategies_binds.size()> batch_cryptos;
+  std::unique_ptr<AESBatchCrypto> aes_batch_crypto;
+  std::unordered_map<std::uint32_t, Key> keys;
+  std::map<std::pair<std::uint8_t, std::string>, std::uint32_t> key_handles;
+  std::uint32_t next_key_handle {};
+  std::unordered_map<int, Connection> connections;
+  int listener { -1 };
+  int epoll { -1 };
+  int stop_event { -1 };
+  bool is_bound {};
+  bool is_stopped {};
+};
+
+#endif
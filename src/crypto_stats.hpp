@@ -0,0 +1,137 @@
+#ifndef CRYPTO_STATS_HPP
+#define CRYPTO_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// Log-linear buckets over nanoseconds: values below 8 are exact, above that every power of two is split into 8 linear
+// sub-buckets, so a percentile is off by at most 12.5%. Recording is a relaxed increment, safe from any thread.
+class LatencyHistogram {
+ public:
+  void record(std::uint64_t nanoseconds) noexcept {
+    counts[bucket_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    auto max { max_nanoseconds.load(std::memory_order_relaxed) };
+    while (nanoseconds > max && max_nanoseconds.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Returns the upper bound of the bucket holding the value at the given fraction, e.g. 0.99.
+  std::uint64_t get_percentile(double fraction) const noexcept {
+    std::uint64_t total {};
+    for (auto &&count : counts) {
+      total += count.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+      return 0;
+    }
+
+    const auto rank { std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * total + 0.5)) };
+    std::uint64_t seen {};
+    for (std::size_t bucket {}; bucket < counts.size(); ++bucket) {
+      seen += counts[bucket].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(upper_bound_of(bucket), get_max());
+      }
+    }
+
+    return get_max();
+  }
+
+  std::uint64_t get_max() const noexcept { return max_nanoseconds.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr std::size_t sub_bucket_bits { 3 };
+  static constexpr std::size_t sub_buckets_count { 1 << sub_bucket_bits };
+
+  static std::size_t bucket_of(std::uint64_t value) noexcept {
+    if (value < sub_buckets_count) {
+      return value;
+    }
+
+    const auto exponent { static_cast<std::size_t>(std::bit_width(value)) - 1 };
+    const auto sub_bucket { (value >> (exponent - sub_bucket_bits)) & (sub_buckets_count - 1) };
+    return ((exponent - sub_bucket_bits + 1) << sub_bucket_bits) + sub_bucket;
+  }
+
+  static std::uint64_t upper_bound_of(std::size_t bucket) noexcept {
+    if (bucket < sub_buckets_count) {
+      return bucket;
+    }
+
+    const auto exponent { (bucket >> sub_bucket_bits) + sub_bucket_bits - 1 };
+    const auto sub_bucket { bucket & (sub_buckets_count - 1) };
+    return ((sub_buckets_count + sub_bucket + 1) << (exponent - sub_bucket_bits)) - 1;
+  }
+
+  std::array<std::atomic<std::uint64_t>, (64 - sub_bucket_bits + 1) * sub_buckets_count> counts {};
+  std::atomic<std::uint64_t> max_nanoseconds {};
+};
+
+class StrategyStats {
+ public:
+  void record(std::size_t input_size, std::size_t output_size, std::chrono::nanoseconds latency,
+              bool is_error) noexcept {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    errors.fetch_add(is_error ? 1 : 0, std::memory_order_relaxed);
+    bytes_in.fetch_add(input_size, std::memory_order_relaxed);
+    bytes_out.fetch_add(output_size, std::memory_order_relaxed);
+    latency_histogram.record(latency.count() > 0 ? latency.count() : 0);
+  }
+
+  std::atomic<std::uint64_t> calls {};
+  std::atomic<std::uint64_t> errors {};
+  std::atomic<std::uint64_t> bytes_in {};
+  std::atomic<std::uint64_t> bytes_out {};
+  LatencyHistogram latency_histogram;
+};
+
+// Per-strategy counters, the set of strategies is fixed on construction so recording never locks. Whoever records
+// holds a nullable pointer to it, which keeps disabled stats down to one branch per call.
+class CryptoStats {
+ public:
+  explicit CryptoStats(std::span<const std::string_view> crypto_strategy_names) {
+    for (auto &&name : crypto_strategy_names) {
+      strategies.try_emplace(name);
+    }
+  }
+
+  void record(std::string_view crypto_strategy_name, std::size_t input_size, std::size_t output_size,
+              std::chrono::nanoseconds latency, bool is_error) noexcept {
+    if (const auto it { strategies.find(crypto_strategy_name) }; it != strategies.end()) {
+      it->second.record(input_size, output_size, latency, is_error);
+    }
+  }
+
+  const std::map<std::string_view, StrategyStats> &get_strategies() const noexcept { return strategies; }
+
+  std::string to_json() const {
+    std::stringstream ss;
+    ss << '{';
+    auto is_first { true };
+    for (auto &&[name, stats] : strategies) {
+      ss << (is_first ? "" : ",") << '"' << name << "\":{\"calls\":" << stats.calls << ",\"errors\":" << stats.errors
+         << ",\"bytes_in\":" << stats.bytes_in << ",\"bytes_out\":" << stats.bytes_out
+         << ",\"latency_ns\":{\"p50\":" << stats.latency_histogram.get_percentile(0.5)
+         << ",\"p99\":" << stats.latency_histogram.get_percentile(0.99)
+         << ",\"max\":" << stats.latency_histogram.get_max() << "}}";
+      is_first = false;
+    }
+    ss << '}';
+    return ss.str();
+  }
+
+ private:
+  std::map<std::string_view, StrategyStats> strategies;
+};
+
+#endif
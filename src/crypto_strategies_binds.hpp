@@ -4,6 +4,7 @@
 #include <array>
 #include <string_view>
 
-constexpr std::array<std::string_view, 3> crypto_strategies_binds { "caesar", "vigenere", "aes" };
+constexpr std::array<std::string_view, 5> crypto_strategies_binds { "caesar", "vigenere", "aes", "aes-ctr",
+                                                                    "cascade" };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef CRYPTO_STRATEGIES_FACTORY_HPP
+#define CRYPTO_STRATEGIES_FACTORY_HPP
+
+#include "aes_crypto.hpp"
+#include "aes_ctr_crypto.hpp"
+#include "caesar_crypto.hpp"
+#include "cascade_crypto.hpp"
+#include "crypto_strategies_binds.hpp"
+#include "input.hpp"
+#include "vigenere_crypto.hpp"
+
+// The ciphers without the cascade, which composes them. The encoding is of the aes ciphertext.
+inline CryptoStrategies make_cipher_strategies(TextEncoding encoding = TextEncoding::HEX) {
+  CryptoStrategies crypto_strategies;
+  crypto_strategies[crypto_strategies_binds[0]].reset(new CaesarCryptoStrategy);
+  crypto_strategies[crypto_strategies_binds[1]].reset(new VigenereCryptoStrategy);
+  crypto_strategies[crypto_strategies_binds[2]].reset(new AESCryptoStrategy { encoding });
+  crypto_strategies[crypto_strategies_binds[3]].reset(new AESCTRCryptoStrategy);
+  return crypto_strategies;
+}
+
+inline CryptoStrategies make_crypto_strategies(TextEncoding encoding = TextEncoding::HEX) {
+  auto crypto_strategies { make_cipher_strategies(encoding) };
+  crypto_strategies[crypto_strategies_binds[4]].reset(new CascadeCryptoStrategy { make_cipher_strategies(encoding) });
+  return crypto_strategies;
+}
+
+// For inputs on several threads, see CryptoInput.
+inline SharedCryptoStrategies make_shared_crypto_strategies() {
+  return std::make_shared<const CryptoStrategies>(make_crypto_strategies());
+}
+
+#endif
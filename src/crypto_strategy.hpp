@@ -2,15 +2,126 @@
 #define CRYPTO_STRATEGY
 
 #include <any>
+#include <expected>
+#include <memory>
+#include <span>
 #include <string>
 
+#include "crypto_stream.hpp"
+#include "errors.hpp"
+#include "prepared_key.hpp"
+
+// The size of the output written by a non-throwing call, or why nothing usable was written.
+using SizeOrError = std::expected<std::size_t, ErrorCode>;
+
+// Strategies keep no per-call state, so one instance can serve any number of threads. A prepared key can hold cipher
+// state and belongs to one thread at a time, each thread prepares its own.
 class CryptoStrategy {
  public:
+  virtual ~CryptoStrategy() = default;
+
   virtual std::string encrypt(const std::string &text_for_encoding, const std::any &any) = 0;
 
   virtual std::string decrypt(const std::string &text_for_decoding, const std::any &anyy) = 0;
 
+  // Parses and validates the key once, so that repeated calls with it skip std::any and the key checks.
+  virtual std::unique_ptr<PreparedKey> prepare_key(const char *key) = 0;
+
+  virtual std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) = 0;
+
+  virtual std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) = 0;
+
+  // Write to a caller-owned buffer of at least max_encrypted_size / max_decrypted_size bytes and return the size of
+  // the result, so one buffer can be reused for any number of messages. in and out must not overlap.
+  virtual std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) = 0;
+
+  virtual std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) = 0;
+
+  // The non-throwing counterparts for bulk work on dirty data, where unwinding would take most of the time. The
+  // defaults catch what the throwing versions throw, strategies that fail on bad input override them instead and
+  // throw from encrypt_into / decrypt_into through or_throw.
+  virtual SizeOrError try_encrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                                       const PreparedKey &key) noexcept {
+    return catch_error([&] { return encrypt_into(in, out, key); });
+  }
+
+  virtual SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                                       const PreparedKey &key) noexcept {
+    return catch_error([&] { return decrypt_into(in, out, key); });
+  }
+
+  std::expected<std::string, ErrorCode> try_encrypt(const std::string &text_for_encoding, const PreparedKey &key) {
+    std::string result(max_encrypted_size(text_for_encoding.size(), key), '\0');
+    const std::span input { text_for_encoding };
+    const std::span output { result };
+    const auto size { try_encrypt_into(std::as_bytes(input), std::as_writable_bytes(output), key) };
+    if (size.has_value() == false) {
+      return std::unexpected { size.error() };
+    }
+
+    result.resize(*size);
+    return result;
+  }
+
+  std::expected<std::string, ErrorCode> try_decrypt(const std::string &text_for_decoding, const PreparedKey &key) {
+    std::string result(max_decrypted_size(text_for_decoding.size(), key), '\0');
+    const std::span input { text_for_decoding };
+    const std::span output { result };
+    const auto size { try_decrypt_into(std::as_bytes(input), std::as_writable_bytes(output), key) };
+    if (size.has_value() == false) {
+      return std::unexpected { size.error() };
+    }
+
+    result.resize(*size);
+    return result;
+  }
+
   virtual bool is_key_numeric() noexcept = 0;
+
+  // Upper bounds of the output size, exact for the length-preserving ciphers.
+  virtual std::size_t max_encrypted_size(std::size_t text_size) noexcept = 0;
+
+  virtual std::size_t max_decrypted_size(std::size_t text_size) noexcept = 0;
+
+  // The bounds for one key, tighter than the ones above where the output size depends on the key.
+  virtual std::size_t max_encrypted_size(std::size_t text_size, const PreparedKey &) noexcept {
+    return max_encrypted_size(text_size);
+  }
+
+  virtual std::size_t max_decrypted_size(std::size_t text_size, const PreparedKey &) noexcept {
+    return max_decrypted_size(text_size);
+  }
+
+  // The stream keeps a reference to the strategy, so it must not outlive it.
+  virtual std::unique_ptr<CryptoStream> create_encryption_stream() = 0;
+
+  virtual std::unique_ptr<CryptoStream> create_decryption_stream() = 0;
+
+ protected:
+  static void check_output_size(std::size_t output_size, std::size_t required_size) {
+    if (output_size < required_size) {
+      throw_exception(output_buffer_is_too_small_error);
+    }
+  }
+
+  static std::size_t or_throw(const SizeOrError &result) {
+    if (result.has_value() == false) {
+      throw_exception(result.error());
+    }
+
+    return *result;
+  }
+
+  template <class Process>
+  static SizeOrError catch_error(Process process) noexcept {
+    try {
+      return process();
+    } catch (const CryptoError &e) {
+      return std::unexpected { e.get_error() };
+    } catch (...) {
+      return std::unexpected { operation_failed_error };
+    }
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,45 @@
+#ifndef CRYPTO_STREAM_HPP
+#define CRYPTO_STREAM_HPP
+
+#include <any>
+#include <istream>
+#include <ostream>
+#include <string>
+
+class CryptoStream {
+ public:
+  virtual ~CryptoStream() = default;
+
+  virtual void begin(const std::any &any) = 0;
+
+  virtual std::string update(const std::string &chunk) = 0;
+
+  virtual std::string finish() = 0;
+};
+
+class ChunkedTransfer {
+ public:
+  static constexpr std::size_t default_chunk_size { 1 << 16 };
+
+  static void run(CryptoStream &stream, const std::any &any, std::istream &in, std::ostream &out,
+                  std::size_t chunk_size = default_chunk_size) {
+    stream.begin(any);
+
+    std::string chunk;
+    while (read_chunk(in, chunk, chunk_size)) {
+      out << stream.update(chunk);
+    }
+
+    out << stream.finish();
+  }
+
+ private:
+  static bool read_chunk(std::istream &in, std::string &chunk, std::size_t chunk_size) {
+    chunk.resize(chunk_size);
+    in.read(chunk.data(), chunk_size);
+    chunk.resize(in.gcount());
+    return chunk.empty() == false;
+  }
+};
+
+#endif
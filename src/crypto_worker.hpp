@@ -0,0 +1,200 @@
+#ifndef CRYPTO_WORKER_HPP
+#define CRYPTO_WORKER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include "crackers.hpp"
+#include "input.hpp"
+
+// Runs one operation at a time on a background thread through the strategy streams, so the caller stays responsive.
+// The text is processed in chunks, which gives the progress and the points where a cancel is noticed. The result is
+// moved into the data view by poll, which the caller runs on its own thread, e.g. once per frame.
+class CryptoWorker : public Input {
+ public:
+  static constexpr std::size_t chunk_size { 1 << 20 };
+
+  CryptoWorker(DataView &data_view, CryptoStrategies &&crypto_strategies)
+      : data_view { data_view }, crypto_strategies { std::move(crypto_strategies) } {}
+
+  void encrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_encoding,
+               const char *key) override {
+    start(crypto_strategy_name, text_for_encoding, key, true);
+  }
+
+  void decrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_decoding,
+               const char *key) override {
+    start(crypto_strategy_name, text_for_decoding, key, false);
+  }
+
+  // Recovers the key of a ciphertext without progress, a cancel is noticed between the steps of the cracker. The plain
+  // text lands in the output text and the key in the cracked key of the data view. A crack isn't counted in the stats.
+  void crack(std::string_view crypto_strategy_name, const std::string &text_for_cracking) {
+    prepare({}, text_for_cracking.size());
+    worker = std::jthread { [this, crypto_strategy_name, text = text_for_cracking](std::stop_token token) {
+      run_crack(token, crypto_strategy_name, text);
+    } };
+  }
+
+  void cancel() { worker.request_stop(); }
+
+  // Cancels the running operation and waits for its thread, after that on_update isn't called any more.
+  void stop() {
+    cancel();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  // Called on the worker thread after every chunk and when the result is ready, e.g. to wake up an idle event loop.
+  // Must be set while no operation is running.
+  void set_on_update(std::function<void()> on_update) { this->on_update = std::move(on_update); }
+
+  // Null disables the stats. Must be set while no operation is running.
+  void set_stats(CryptoStats *stats) noexcept { this->stats = stats; }
+
+  // Returns true when a result was moved into the data view.
+  bool poll() {
+    if (is_finished == false) {
+      return false;
+    }
+
+    if (worker.joinable()) {
+      worker.join();
+    }
+
+    std::lock_guard lock { result_mutex };
+    data_view.output_text.swap(result);
+    data_view.has_error = has_error;
+    data_view.cracked_key.swap(cracked_key);
+    result.clear();
+    cracked_key.clear();
+    is_finished = false;
+    is_running = false;
+    return true;
+  }
+
+  void wait() {
+    if (worker.joinable()) {
+      worker.join();
+    }
+    poll();
+  }
+
+  bool get_is_running() const noexcept { return is_running; }
+
+  std::size_t get_processed_size() const noexcept { return processed_size; }
+
+  std::size_t get_total_size() const noexcept { return total_size; }
+
+  float get_progress() const noexcept {
+    return total_size == 0 ? 0.0f : static_cast<float>(processed_size) / static_cast<float>(total_size);
+  }
+
+ private:
+  void start(std::string_view crypto_strategy_name, const std::string &text, const char *key, bool is_encryption) {
+    prepare(crypto_strategy_name, text.size());
+    auto &strategy { *crypto_strategies.at(crypto_strategy_name) };
+    worker = std::jthread { [this, &strategy, text, key = std::string { key }, is_encryption](std::stop_token token) {
+      run(token, strategy, text, key, is_encryption);
+    } };
+  }
+
+  // Operations without a strategy name are not counted in the stats.
+  void prepare(std::string_view crypto_strategy_name, std::size_t size) {
+    worker = {};
+    poll();
+
+    processed_size = 0;
+    total_size = size;
+    is_running = true;
+    running_strategy_name = crypto_strategy_name;
+    started_at = stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {};
+  }
+
+  void run(std::stop_token stop_token, CryptoStrategy &strategy, const std::string &text, const std::string &key,
+           bool is_encryption) {
+    try {
+      auto stream { is_encryption ? strategy.create_encryption_stream() : strategy.create_decryption_stream() };
+      stream->begin(strategy.is_key_numeric() ? std::any { std::stoi(key) } : std::any { key.c_str() });
+
+      std::string output;
+      output.reserve(is_encryption ? strategy.max_encrypted_size(text.size())
+                                   : strategy.max_decrypted_size(text.size()));
+      for (std::size_t offset {}; offset < text.size(); offset += chunk_size) {
+        if (stop_token.stop_requested()) {
+          complete(operation_is_cancelled_error, true);
+          return;
+        }
+
+        output += stream->update(text.substr(offset, chunk_size));
+        processed_size = std::min(offset + chunk_size, text.size());
+        notify();
+      }
+      output += stream->finish();
+
+      complete(std::move(output), false);
+    } catch (const std::exception &e) {
+      complete(e.what(), true);
+    }
+  }
+
+  void run_crack(std::stop_token stop_token, std::string_view crypto_strategy_name, const std::string &text) {
+    try {
+      auto result { Crackers::crack(crypto_strategy_name, text, stop_token) };
+      processed_size = text.size();
+      complete(std::move(result.plain_text), false, std::move(result.key));
+    } catch (const std::exception &e) {
+      complete(e.what(), true);
+    }
+  }
+
+  // A cancelled operation is counted as an error.
+  void complete(std::string &&output, bool is_error, std::string &&key = {}) {
+    if (stats && running_strategy_name.empty() == false) {
+      stats->record(running_strategy_name, total_size, is_error ? 0 : output.size(),
+                    std::chrono::steady_clock::now() - started_at, is_error);
+    }
+
+    {
+      std::lock_guard lock { result_mutex };
+      result = std::move(output);
+      cracked_key = std::move(key);
+      has_error = is_error;
+      is_finished = true;
+    }
+    notify();
+  }
+
+  void notify() {
+    if (on_update) {
+      on_update();
+    }
+  }
+
+  DataView &data_view;
+  CryptoStrategies crypto_strategies;
+  std::function<void()> on_update;
+  CryptoStats *stats {};
+
+  std::mutex result_mutex;
+  std::string result;
+  std::string cracked_key;
+  bool has_error {};
+
+  std::atomic<bool> is_finished {};
+  std::atomic<bool> is_running {};
+  std::atomic<std::size_t> processed_size {};
+  std::atomic<std::size_t> total_size {};
+  std::string_view running_strategy_name;
+  std::chrono::steady_clock::time_point started_at;
+
+  // Declared last, so it is stopped and joined before the state it uses is destroyed.
+  std::jthread worker;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include <csignal>
+#include <iostream>
+#include <span>
+#include <string>
+
+#include "crypto_daemon.hpp"
+
+namespace {
+
+constexpr auto usage {
+  "Usage: crypto_daemon [--threads=<count>] [--encoding=<raw|hex|base64>] <socket>\n"
+  "       serves the strategies over a Unix domain socket until SIGINT or SIGTERM\n"
+  "       --threads sets the workers per strategy, one per core by default\n"
+  "       --encoding sets how aes writes its ciphertext, hex by default\n"
+};
+
+constexpr std::string_view threads_flag { "--threads=" };
+constexpr std::string_view encoding_flag { "--encoding=" };
+
+CryptoDaemon *running_daemon {};
+
+void stop_running_daemon(int) {
+  if (running_daemon != nullptr) {
+    running_daemon->stop();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  try {
+    std::span<char *> args { argv + 1, argv + argc };
+    unsigned threads { std::thread::hardware_concurrency() };
+    TextEncoding encoding { TextEncoding::HEX };
+    for (; args.empty() == false && std::string_view { args[0] }.starts_with("--"); args = args.subspan(1)) {
+      const std::string_view flag { args[0] };
+      if (flag.starts_with(threads_flag)) {
+        threads = static_cast<unsigned>(std::stoul(std::string { flag.substr(threads_flag.size()) }));
+      } else if (flag.starts_with(encoding_flag)) {
+        const auto parsed { TextCodec::parse(flag.substr(encoding_flag.size())) };
+        if (parsed.has_value() == false) {
+          throw_exception(unknown_encoding_error);
+        }
+        encoding = *parsed;
+      } else {
+        throw_exception(unknown_flag_error);
+      }
+    }
+    if (args.size() != 1) {
+      throw_exception(wrong_arguments_count_error);
+    }
+
+    CryptoDaemon daemon { args[0], encoding, threads };
+    running_daemon = &daemon;
+    std::signal(SIGINT, stop_running_daemon);
+    std::signal(SIGTERM, stop_running_daemon);
+    try {
+      daemon.run();
+    } catch (...) {
+      // The handlers must not reach the daemon once it is destroyed.
+      running_daemon = nullptr;
+      throw;
+    }
+    running_daemon = nullptr;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << usage;
+    return 2;
+  }
+}
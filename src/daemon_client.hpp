@@ -0,0 +1,148 @@
+#ifndef DAEMON_CLIENT_HPP
+#define DAEMON_CLIENT_HPP
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "crypto_strategies_binds.hpp"
+#include "daemon_protocol.hpp"
+#include "errors.hpp"
+
+// A blocking connection to CryptoDaemon. send and receive can be used apart to keep several requests in flight, the
+// calls below them wait for each answer. An error of the daemon is thrown as daemon_error with its message.
+class DaemonClient {
+ public:
+  explicit DaemonClient(const std::string &socket_path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+      throw_exception(cannot_connect_error);
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+
+    descriptor = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor < 0 || ::connect(descriptor, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+      close_socket();
+      throw_exception(cannot_connect_error);
+    }
+  }
+
+  DaemonClient(const DaemonClient &) = delete;
+  DaemonClient &operator=(const DaemonClient &) = delete;
+
+  ~DaemonClient() { close_socket(); }
+
+  static std::uint8_t get_strategy_id(std::string_view crypto_strategy_name) {
+    const auto it { std::ranges::find(crypto_strategies_binds, crypto_strategy_name) };
+    if (it == crypto_strategies_binds.end()) {
+      throw_exception(unknown_crypto_strategy_error);
+    }
+
+    return static_cast<std::uint8_t>(it - crypto_strategies_binds.begin());
+  }
+
+  std::uint32_t register_key(std::string_view crypto_strategy_name, std::string_view key) {
+    const auto response { call({ .strategy = get_strategy_id(crypto_strategy_name),
+                                 .mode = DaemonMode::REGISTER_KEY,
+                                 .payload = key }) };
+    const auto key_handle { DaemonFrames::decode_key_handle(response) };
+    if (key_handle.has_value() == false) {
+      throw_exception(operation_failed_error);
+    }
+
+    return *key_handle;
+  }
+
+  std::string encrypt(std::string_view crypto_strategy_name, std::uint32_t key_handle, std::string_view text) {
+    return std::string { call({ .strategy = get_strategy_id(crypto_strategy_name),
+                                .mode = DaemonMode::ENCRYPTION,
+                                .key_handle = key_handle,
+                                .payload = text }) };
+  }
+
+  std::string decrypt(std::string_view crypto_strategy_name, std::uint32_t key_handle, std::string_view text) {
+    return std::string { call({ .strategy = get_strategy_id(crypto_strategy_name),
+                                .mode = DaemonMode::DECRYPTION,
+                                .key_handle = key_handle,
+                                .payload = text }) };
+  }
+
+  void send(const DaemonRequest &request) {
+    output.clear();
+    DaemonFrames::append(output, request);
+    for (std::size_t written {}; written < output.size();) {
+      const auto count { ::send(descriptor, output.data() + written, output.size() - written, MSG_NOSIGNAL) };
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        throw_exception(connection_is_closed_error);
+      }
+      written += count;
+    }
+  }
+
+  // Tells the daemon that no more requests come, the responses still do.
+  void shutdown_sending() noexcept { ::shutdown(descriptor, SHUT_WR); }
+
+  // The payload stays valid until the next receive.
+  DaemonResponse receive() {
+    input.erase(0, std::exchange(received_size, 0));
+    while (true) {
+      const auto response { DaemonFrames::parse_response(input) };
+      if (response.has_value()) {
+        received_size = DaemonFrames::get_frame_size(*response);
+        return *response;
+      }
+
+      const auto size { input.size() };
+      input.resize(size + read_size);
+      const auto count { ::read(descriptor, input.data() + size, read_size) };
+      input.resize(size + static_cast<std::size_t>(std::max<ssize_t>(count, 0)));
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        throw_exception(connection_is_closed_error);
+      }
+    }
+  }
+
+ private:
+  static constexpr std::size_t read_size { 1 << 16 };
+
+  std::string_view call(DaemonRequest request) {
+    request.id = next_id++;
+    send(request);
+    const auto response { receive() };
+    if (response.id != request.id) {
+      throw_exception(operation_failed_error);
+    }
+    if (response.is_error) {
+      throw CryptoError { daemon_error, std::string { response.payload } };
+    }
+
+    return response.payload;
+  }
+
+  void close_socket() noexcept {
+    if (descriptor >= 0) {
+      ::close(descriptor);
+    }
+  }
+
+  int descriptor { -1 };
+  std::uint32_t next_id {};
+  std::string input;
+  std::size_t received_size {};
+  std::string output;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "daemon_client.hpp"
+
+namespace {
+
+constexpr auto usage {
+  "Usage: crypto_daemon_load [--connections=<count>] [--requests=<count>] [--size=<bytes>] [--depth=<count>] "
+  "<socket> <strategy> <key>\n"
+  "       sends requests of random letters from every connection, each keeping depth of them in flight, and prints\n"
+  "       the throughput and the p50 / p99 latency\n"
+};
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  unsigned connections_count { 8 };
+  std::size_t requests_count { 10000 };
+  std::size_t size { 64 };
+  std::size_t depth { 4 };
+  std::string socket_path;
+  std::string_view crypto_strategy_name;
+  std::string_view key;
+};
+
+struct Results {
+  std::vector<Clock::duration> latencies;
+  std::size_t errors_count {};
+};
+
+Options parse_options(std::span<char *> args) {
+  Options options;
+  for (; args.empty() == false && std::string_view { args[0] }.starts_with("--"); args = args.subspan(1)) {
+    const std::string_view flag { args[0] };
+    const auto value_at { flag.find('=') };
+    if (value_at == std::string_view::npos) {
+      throw_exception(unknown_flag_error);
+    }
+
+    const auto name { flag.substr(0, value_at + 1) };
+    const auto value { std::stoul(std::string { flag.substr(value_at + 1) }) };
+    if (name == "--connections=") {
+      options.connections_count = static_cast<unsigned>(std::max(value, 1ul));
+    } else if (name == "--requests=") {
+      options.requests_count = value;
+    } else if (name == "--size=") {
+      options.size = value;
+    } else if (name == "--depth=") {
+      options.depth = std::max(value, 1ul);
+    } else {
+      throw_exception(unknown_flag_error);
+    }
+  }
+  if (args.size() != 3) {
+    throw_exception(wrong_arguments_count_error);
+  }
+
+  options.socket_path = args[0];
+  options.crypto_strategy_name = args[1];
+  options.key = args[2];
+  return options;
+}
+
+// Keeps depth requests in flight on one connection, the latency of each is from its send to its response.
+Results run_connection(const Options &options, unsigned connection) {
+  DaemonClient client { options.socket_path };
+  const DaemonRequest request_template { .strategy = DaemonClient::get_strategy_id(options.crypto_strategy_name),
+                                         .mode = DaemonMode::ENCRYPTION,
+                                         .key_handle = client.register_key(options.crypto_strategy_name,
+                                                                           options.key),
+                                         .payload = {} };
+  std::string text(options.size, '\0');
+  std::vector<Clock::time_point> sent_at(options.requests_count);
+  Results results;
+  results.latencies.reserve(options.requests_count);
+
+  std::uint32_t sent_count {};
+  for (std::size_t received_count {}; received_count < options.requests_count; ++received_count) {
+    for (; sent_count < options.requests_count && sent_count - received_count < options.depth; ++sent_count) {
+      for (std::size_t index {}; index < text.size(); ++index) {
+        text[index] = static_cast<char>('a' + (sent_count * 7 + index * 13 + connection) % 26);
+      }
+      auto request { request_template };
+      request.id = sent_count;
+      request.payload = text;
+      sent_at[sent_count] = Clock::now();
+      client.send(request);
+    }
+
+    const auto response { client.receive() };
+    results.latencies.push_back(Clock::now() - sent_at.at(response.id));
+    results.errors_count += response.is_error;
+  }
+  return results;
+}
+
+double to_microseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::micro> { duration }.count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  try {
+    const auto options { parse_options({ argv + 1, argv + argc }) };
+
+    std::vector<Results> results(options.connections_count);
+    const auto start { Clock::now() };
+    {
+      std::vector<std::jthread> connections;
+      for (unsigned connection {}; connection < options.connections_count; ++connection) {
+        connections.emplace_back([&, connection] {
+          try {
+            results[connection] = run_connection(options, connection);
+          } catch (const std::exception &e) {
+            std::cerr << e.what();
+          }
+        });
+      }
+    }
+    const std::chrono::duration<double> elapsed { Clock::now() - start };
+
+    std::vector<Clock::duration> latencies;
+    std::size_t errors_count {};
+    for (auto &&result : results) {
+      latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+      errors_count += result.errors_count;
+    }
+    if (latencies.empty()) {
+      return 1;
+    }
+
+    std::ranges::sort(latencies);
+    const auto percentile { [&latencies](double fraction) {
+      return to_microseconds(latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1))]);
+    } };
+    std::cout << latencies.size() << " requests, " << errors_count << " errors, " << elapsed.count() << " s, "
+              << latencies.size() / elapsed.count() << " requests/s, p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us\n";
+    return errors_count == 0 ? 0 : 1;
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << usage;
+    return 2;
+  }
+}
@@ -0,0 +1,158 @@
+#ifndef DAEMON_PROTOCOL_HPP
+#define DAEMON_PROTOCOL_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+enum class DaemonMode : std::uint8_t { REGISTER_KEY, ENCRYPTION, DECRYPTION };
+
+// A key is registered once per strategy, the daemon answers with a handle that the encryptions and decryptions then
+// name instead of sending the key along every time. The payload of REGISTER_KEY is the key.
+struct DaemonRequest {
+  // payload size, id, key handle, strategy, mode
+  static constexpr std::size_t header_size { 14 };
+
+  std::uint32_t id {};
+  // Index into crypto_strategies_binds.
+  std::uint8_t strategy {};
+  DaemonMode mode {};
+  std::uint32_t key_handle {};
+  std::string_view payload;
+};
+
+// The payload is the output, the key handle of a REGISTER_KEY, or the error message.
+struct DaemonResponse {
+  // payload size, id, status
+  static constexpr std::size_t header_size { 9 };
+
+  std::uint32_t id {};
+  bool is_error {};
+  std::string_view payload;
+};
+
+// Frames are a fixed header and the payload. Both ends run on one machine, so the fields are in host byte order. Every
+// request gets one response with its id, but the responses of pipelined requests may come back in any order.
+class DaemonFrames {
+ public:
+  // A peer that announces more is dropped.
+  static constexpr std::uint32_t max_payload_size { 1 << 24 };
+
+  static void append(std::string &out, const DaemonRequest &request) {
+    const auto header { out.size() };
+    out.resize(header + DaemonRequest::header_size);
+    auto *at { out.data() + header };
+    at = put(at, static_cast<std::uint32_t>(request.payload.size()));
+    at = put(at, request.id);
+    at = put(at, request.key_handle);
+    at = put(at, request.strategy);
+    put(at, static_cast<std::uint8_t>(request.mode));
+    out += request.payload;
+  }
+
+  static void append(std::string &out, const DaemonResponse &response) {
+    const auto header { out.size() };
+    out.resize(header + DaemonResponse::header_size);
+    auto *at { out.data() + header };
+    at = put(at, static_cast<std::uint32_t>(response.payload.size()));
+    at = put(at, response.id);
+    put(at, static_cast<std::uint8_t>(response.is_error));
+    out += response.payload;
+  }
+
+  // The frame at the front of in, or nothing while it is incomplete. The payload points into in.
+  static std::optional<DaemonRequest> parse_request(std::string_view in) noexcept {
+    const auto payload { get_payload(in, DaemonRequest::header_size) };
+    if (payload.has_value() == false) {
+      return std::nullopt;
+    }
+
+    DaemonRequest request { .payload = *payload };
+    const auto *at { in.data() + sizeof(std::uint32_t) };
+    at = get(at, request.id);
+    at = get(at, request.key_handle);
+    at = get(at, request.strategy);
+    std::uint8_t mode {};
+    get(at, mode);
+    request.mode = static_cast<DaemonMode>(mode);
+    return request;
+  }
+
+  static std::optional<DaemonResponse> parse_response(std::string_view in) noexcept {
+    const auto payload { get_payload(in, DaemonResponse::header_size) };
+    if (payload.has_value() == false) {
+      return std::nullopt;
+    }
+
+    DaemonResponse response { .payload = *payload };
+    const auto *at { in.data() + sizeof(std::uint32_t) };
+    at = get(at, response.id);
+    std::uint8_t status {};
+    get(at, status);
+    response.is_error = status != 0;
+    return response;
+  }
+
+  // Known as soon as the size field is in, long before the frame is.
+  static bool is_oversized(std::string_view in) noexcept {
+    std::uint32_t payload_size {};
+    if (in.size() < sizeof(payload_size)) {
+      return false;
+    }
+
+    get(in.data(), payload_size);
+    return payload_size > max_payload_size;
+  }
+
+  template <class Frame>
+  static std::size_t get_frame_size(const Frame &frame) noexcept {
+    return Frame::header_size + frame.payload.size();
+  }
+
+  static std::string encode_key_handle(std::uint32_t key_handle) {
+    std::string out(sizeof(key_handle), '\0');
+    put(out.data(), key_handle);
+    return out;
+  }
+
+  static std::optional<std::uint32_t> decode_key_handle(std::string_view payload) noexcept {
+    std::uint32_t key_handle {};
+    if (payload.size() != sizeof(key_handle)) {
+      return std::nullopt;
+    }
+
+    get(payload.data(), key_handle);
+    return key_handle;
+  }
+
+ private:
+  static std::optional<std::string_view> get_payload(std::string_view in, std::size_t header_size) noexcept {
+    std::uint32_t payload_size {};
+    if (in.size() < header_size) {
+      return std::nullopt;
+    }
+
+    get(in.data(), payload_size);
+    if (in.size() - header_size < payload_size) {
+      return std::nullopt;
+    }
+
+    return in.substr(header_size, payload_size);
+  }
+
+  template <class Field>
+  static char *put(char *at, Field field) noexcept {
+    std::memcpy(at, &field, sizeof(field));
+    return at + sizeof(field);
+  }
+
+  template <class Field>
+  static const char *get(const char *at, Field &field) noexcept {
+    std::memcpy(&field, at, sizeof(field));
+    return at + sizeof(field);
+  }
+};
+
+#endif
@@ -6,6 +6,9 @@
 class DataView {
  public:
   std::string output_text;
+  bool has_error {};
+  // Set by a crack next to the plain text in output_text, empty otherwise.
+  std::string cracked_key;
 };
 
-#endif
\ No newline at end of file
+#endif
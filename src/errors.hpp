@@ -3,11 +3,27 @@
 
 #include <source_location>
 #include <sstream>
+#include <stdexcept>
 
-void throw_exception(const char *const error, const std::source_location &location = std::source_location::current()) {
+// Keeps the error constant it was thrown with, so callers can tell errors apart without parsing the message.
+class CryptoError : public std::runtime_error {
+ public:
+  CryptoError(const char *const error, const std::string &message) : std::runtime_error { message }, error { error } {}
+
+  const char *get_error() const noexcept { return error; }
+
+ private:
+  const char *error;
+};
+
+// The static error code of the non-throwing API, one of the constants below compared by address.
+using ErrorCode = const char *;
+
+[[noreturn]] inline void throw_exception(const char *const error,
+                                         const std::source_location &location = std::source_location::current()) {
   std::stringstream ss;
   ss << location.function_name() << ":\n" << error << '\n';
-  throw std::runtime_error { ss.str() };
+  throw CryptoError { error, ss.str() };
 }
 
 inline constexpr const char *const broken_text_error { "Text is broken." };
@@ -15,6 +31,37 @@ inline constexpr const char *const key_longer_than_text_error { "Key can't be lo
 inline constexpr const char *const key_contains_non_alphabetic_chars_error {
   "Key contains non-alphabetic characters."
 };
+inline constexpr const char *const key_is_empty_error { "Key can't be empty." };
 inline constexpr const char *const case_is_different_error { "The case is different." };
+inline constexpr const char *const invalid_key_length_error { "Key must be 16, 24 or 32 bytes long." };
+inline constexpr const char *const broken_ciphertext_error { "Ciphertext is broken." };
+inline constexpr const char *const wrong_arguments_count_error { "Wrong number of arguments." };
+inline constexpr const char *const unknown_crypto_strategy_error { "Unknown crypto strategy." };
+inline constexpr const char *const unknown_crypto_mode_error { "Unknown crypto mode." };
+inline constexpr const char *const unknown_flag_error { "Unknown flag." };
+inline constexpr const char *const trace_needs_path_error { "Trace needs an output path." };
+inline constexpr const char *const unknown_encoding_error { "Unknown encoding, use raw, hex or base64." };
+inline constexpr const char *const cannot_open_file_error { "Can't open the file." };
+inline constexpr const char *const cannot_write_output_error { "Can't write the output." };
+inline constexpr const char *const cannot_map_file_error { "Can't map the file into memory." };
+inline constexpr const char *const file_mode_needs_paths_error { "File mode needs input and output paths." };
+inline constexpr const char *const output_is_too_large_error { "Output is larger than expected." };
+inline constexpr const char *const output_buffer_is_too_small_error { "Output buffer is too small." };
+inline constexpr const char *const wrong_keys_count_error { "Need one key per record." };
+inline constexpr const char *const operation_is_cancelled_error { "Operation is cancelled." };
+inline constexpr const char *const operation_failed_error { "Operation failed." };
+inline constexpr const char *const not_enough_letters_error { "Text has too few letters to crack." };
+inline constexpr const char *const crack_is_not_supported_error { "Strategy can't be cracked." };
+inline constexpr const char *const cascade_key_error {
+  "Cascade key must be 1 to 4 stages like vigenere:lemon|caesar:3."
+};
+inline constexpr const char *const cannot_listen_error { "Can't listen on the socket." };
+inline constexpr const char *const cannot_connect_error { "Can't connect to the daemon." };
+inline constexpr const char *const connection_is_closed_error { "Connection is closed." };
+inline constexpr const char *const unknown_key_handle_error { "Unknown key handle." };
+inline constexpr const char *const too_many_keys_error { "Too many keys on one connection." };
+inline constexpr const char *const daemon_error { "The daemon failed the request." };
+inline constexpr const char *const invalid_key_error { "Key is invalid." };
+inline constexpr const char *const foreign_key_error { "Key was prepared by another strategy." };
 
 #endif
\ No newline at end of file
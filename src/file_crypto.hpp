@@ -0,0 +1,78 @@
+#ifndef FILE_CRYPTO_HPP
+#define FILE_CRYPTO_HPP
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <span>
+#include <string>
+
+#include "crypto_strategy.hpp"
+#include "errors.hpp"
+#include "mapped_file.hpp"
+
+// Runs a memory-mapped input through encrypt_into / decrypt_into straight into a preallocated mapping of the output,
+// so neither file is ever held in a std::string. The output is written to a temporary file next to it and renamed
+// over the output path only once the whole input went through, so a failure leaves the output as it was. That makes
+// the same path for input and output safe for every cipher.
+class FileCrypto {
+ public:
+  struct Report {
+    std::size_t bytes_in {};
+    std::size_t bytes_out {};
+    double seconds {};
+
+    double megabytes_per_second() const noexcept {
+      return seconds > 0 ? static_cast<double>(bytes_in) / (1024 * 1024) / seconds : 0;
+    }
+  };
+
+  static Report encrypt(CryptoStrategy &strategy, const char *key, const std::string &input_path,
+                        const std::string &output_path) {
+    return process(strategy, key, input_path, output_path, true);
+  }
+
+  static Report decrypt(CryptoStrategy &strategy, const char *key, const std::string &input_path,
+                        const std::string &output_path) {
+    return process(strategy, key, input_path, output_path, false);
+  }
+
+ private:
+  // The key is checked before any file is created.
+  static Report process(CryptoStrategy &strategy, const char *key, const std::string &input_path,
+                        const std::string &output_path, bool is_encryption) {
+    const auto start { std::chrono::steady_clock::now() };
+    const auto prepared_key { strategy.prepare_key(key) };
+
+    MappedFile input { input_path, MappedFile::Access::READ };
+    const std::span in { std::as_bytes(input.data()) };
+    const auto max_size { is_encryption ? strategy.max_encrypted_size(in.size(), *prepared_key)
+                                        : strategy.max_decrypted_size(in.size(), *prepared_key) };
+    MappedFile output { get_temporary_path(output_path), max_size };
+    const std::span out { std::as_writable_bytes(output.data()) };
+    Report report { .bytes_in = in.size() };
+    report.bytes_out = is_encryption ? strategy.encrypt_into(in, out, *prepared_key)
+                                     : strategy.decrypt_into(in, out, *prepared_key);
+    output.set_final_size(report.bytes_out);
+    output.replace(output_path, get_output_mode(input, output_path));
+
+    report.seconds = std::chrono::duration<double> { std::chrono::steady_clock::now() - start }.count();
+    return report;
+  }
+
+  // In the directory of the output, so that the rename stays within one file system. MappedFile makes it unique.
+  static std::string get_temporary_path(const std::string &output_path) { return output_path + ".tmp"; }
+
+  // An existing output keeps its permissions, which covers the same path for input and output. A new one gets those
+  // of the input without the execute bits, so a private input doesn't turn into an output others can read.
+  static mode_t get_output_mode(MappedFile &input, const std::string &output_path) {
+    struct stat status {};
+    if (::stat(output_path.c_str(), &status) == 0) {
+      return status.st_mode & 07777;
+    }
+
+    return input.get_mode() & 0666;
+  }
+};
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef HEX_CODEC_HPP
+#define HEX_CODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.hpp"
+
+// Upper-case hex like CryptoPP::HexEncoder, but straight between caller buffers so that no filter chain is allocated.
+// Whole vectors go through byte shuffles, the tails through the tables.
+class HexCodec {
+ public:
+  // Writes exactly 2 * size digits.
+  static void encode(const std::uint8_t *decoded, std::size_t size, char *encoded) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_avx2()) {
+      return encode_avx2(decoded, size, encoded);
+    }
+    if (CpuFeatures::has_ssse3()) {
+      return encode_ssse3(decoded, size, encoded);
+    }
+#endif
+    encode_scalar(decoded, size, encoded);
+  }
+
+  // Reads exactly 2 * size digits of either case, returns false on the first non-hex char.
+  static bool decode(const char *encoded, std::size_t size, std::uint8_t *decoded) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_avx2()) {
+      return decode_avx2(encoded, size, decoded);
+    }
+    if (CpuFeatures::has_ssse3()) {
+      return decode_ssse3(encoded, size, decoded);
+    }
+#endif
+    return decode_scalar(encoded, size, decoded);
+  }
+
+  static void encode_scalar(const std::uint8_t *decoded, std::size_t size, char *encoded) noexcept {
+    for (std::size_t i {}; i < size; ++i) {
+      encoded[2 * i] = digits[decoded[i] >> 4];
+      encoded[2 * i + 1] = digits[decoded[i] & 0xf];
+    }
+  }
+
+  static bool decode_scalar(const char *encoded, std::size_t size, std::uint8_t *decoded) noexcept {
+    for (std::size_t i {}; i < size; ++i) {
+      const auto high { values[static_cast<std::uint8_t>(encoded[2 * i])] };
+      const auto low { values[static_cast<std::uint8_t>(encoded[2 * i + 1])] };
+      if ((high | low) == invalid) {
+        return false;
+      }
+      decoded[i] = static_cast<std::uint8_t>(high << 4 | low);
+    }
+
+    return true;
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // Both nibbles index the digits with a shuffle, the unpacks interleave them into high, low order.
+  __attribute__((target("ssse3"))) static void encode_ssse3(const std::uint8_t *decoded, std::size_t size,
+                                                             char *encoded) noexcept {
+    const auto table { _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits)) };
+    std::size_t i {};
+    for (; i + 16 <= size; i += 16) {
+      const auto bytes { _mm_loadu_si128(reinterpret_cast<const __m128i *>(decoded + i)) };
+      const auto high { _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0xf))) };
+      const auto low { _mm_shuffle_epi8(table, _mm_and_si128(bytes, _mm_set1_epi8(0xf))) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(encoded + 2 * i), _mm_unpacklo_epi8(high, low));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(encoded + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    encode_scalar(decoded + i, size - i, encoded + 2 * i);
+  }
+
+  // The unpacks work inside 128-bit lanes, so the halves are put back in order across the lanes.
+  __attribute__((target("avx2"))) static void encode_avx2(const std::uint8_t *decoded, std::size_t size,
+                                                           char *encoded) noexcept {
+    const auto table { _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(digits))) };
+    std::size_t i {};
+    for (; i + 32 <= size; i += 32) {
+      const auto bytes { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(decoded + i)) };
+      const auto high { _mm256_shuffle_epi8(table,
+                                            _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0xf))) };
+      const auto low { _mm256_shuffle_epi8(table, _mm256_and_si256(bytes, _mm256_set1_epi8(0xf))) };
+      const auto first { _mm256_unpacklo_epi8(high, low) };
+      const auto second { _mm256_unpackhi_epi8(high, low) };
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(encoded + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(encoded + 2 * i + 32),
+                          _mm256_permute2x128_si256(first, second, 0x31));
+    }
+
+    encode_scalar(decoded + i, size - i, encoded + 2 * i);
+  }
+
+  __attribute__((target("ssse3"))) static bool decode_ssse3(const char *encoded, std::size_t size,
+                                                             std::uint8_t *decoded) noexcept {
+    std::size_t i {};
+    for (; i + 16 <= size; i += 16) {
+      __m128i first;
+      __m128i second;
+      if (to_values(_mm_loadu_si128(reinterpret_cast<const __m128i *>(encoded + 2 * i)), first) == false ||
+          to_values(_mm_loadu_si128(reinterpret_cast<const __m128i *>(encoded + 2 * i + 16)), second) == false) {
+        return false;
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(decoded + i), _mm_packus_epi16(join_nibbles(first),
+                                                                                   join_nibbles(second)));
+    }
+
+    return decode_scalar(encoded + 2 * i, size - i, decoded + i);
+  }
+
+  __attribute__((target("avx2"))) static bool decode_avx2(const char *encoded, std::size_t size,
+                                                           std::uint8_t *decoded) noexcept {
+    std::size_t i {};
+    for (; i + 32 <= size; i += 32) {
+      __m256i first;
+      __m256i second;
+      if (to_values(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(encoded + 2 * i)), first) == false ||
+          to_values(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(encoded + 2 * i + 32)), second) == false) {
+        return false;
+      }
+
+      // The pack interleaves the lanes of both vectors.
+      const auto packed { _mm256_packus_epi16(join_nibbles(first), join_nibbles(second)) };
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(decoded + i),
+                          _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    return decode_scalar(encoded + 2 * i, size - i, decoded + i);
+  }
+#endif
+
+ private:
+  static constexpr const char *digits { "0123456789ABCDEF" };
+  static constexpr std::uint8_t invalid { 0xff };
+
+#ifdef CRYPTO_X86_KERNELS
+  // Digits to their values, false when any char is not a hex digit.
+  __attribute__((target("ssse3"))) static bool to_values(__m128i chars, __m128i &values) noexcept {
+    const auto lower { _mm_or_si128(chars, _mm_set1_epi8(0x20)) };
+    const auto is_digit { SimdBytes::in_range(chars, '0', '9') };
+    const auto is_letter { SimdBytes::in_range(lower, 'a', 'f') };
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff) {
+      return false;
+    }
+
+    values = _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                          _mm_and_si128(is_letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    return true;
+  }
+
+  __attribute__((target("avx2"))) static bool to_values(__m256i chars, __m256i &values) noexcept {
+    const auto lower { _mm256_or_si256(chars, _mm256_set1_epi8(0x20)) };
+    const auto is_digit { SimdBytes::in_range(chars, '0', '9') };
+    const auto is_letter { SimdBytes::in_range(lower, 'a', 'f') };
+    if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1) {
+      return false;
+    }
+
+    values = _mm256_or_si256(_mm256_and_si256(is_digit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+                             _mm256_and_si256(is_letter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+    return true;
+  }
+
+  // Every pair of nibbles becomes high * 16 + low in a 16-bit lane.
+  __attribute__((target("ssse3"))) static __m128i join_nibbles(__m128i values) noexcept {
+    return _mm_maddubs_epi16(values, _mm_set1_epi16(0x0110));
+  }
+
+  __attribute__((target("avx2"))) static __m256i join_nibbles(__m256i values) noexcept {
+    return _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0110));
+  }
+#endif
+
+  static constexpr std::array<std::uint8_t, 256> make_values() {
+    std::array<std::uint8_t, 256> result;
+    result.fill(invalid);
+    for (auto i { 0 }; i < 10; ++i) {
+      result['0' + i] = i;
+    }
+    for (auto i { 0 }; i < 6; ++i) {
+      result['A' + i] = result['a' + i] = 10 + i;
+    }
+    return result;
+  }
+
+  static const std::array<std::uint8_t, 256> values;
+};
+
+inline constexpr std::array<std::uint8_t, 256> HexCodec::values { HexCodec::make_values() };
+
+#endif
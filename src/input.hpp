@@ -1,16 +1,22 @@
 #ifndef INPUT_HPP
 #define INPUT_HPP
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
+#include "crypto_stats.hpp"
 #include "crypto_strategy.hpp"
 #include "data_view.hpp"
+#include "trace.hpp"
 
 using CryptoStrategies = std::unordered_map<std::string_view, std::unique_ptr<CryptoStrategy>>;
 
+// A registry that is never modified after construction, so any number of threads can look strategies up in it.
+using SharedCryptoStrategies = std::shared_ptr<const CryptoStrategies>;
+
 class Input {
  public:
   virtual void encrypt(const std::string_view &crypto_name, const std::string &text_for_encoding, const char *key) = 0;
@@ -18,32 +24,57 @@ class Input {
   virtual void decrypt(const std::string_view &crypto_name, const std::string &text_for_decoding, const char *key) = 0;
 };
 
+// Writes to its own data view, so each thread needs its own input. Inputs on several threads can share one registry,
+// the strategies are safe for concurrent use.
 class CryptoInput : public Input {
  public:
   CryptoInput(DataView &data_view, CryptoStrategies &&crypto_strategies)
+      : CryptoInput { data_view, std::make_shared<const CryptoStrategies>(std::move(crypto_strategies)) } {}
+
+  CryptoInput(DataView &data_view, SharedCryptoStrategies crypto_strategies)
       : data_view { data_view }, crypto_strategies { std::move(crypto_strategies) } {}
 
   void encrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_encoding,
                const char *key) override {
+    const auto start { stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {} };
     try {
       try_encrypt(crypto_strategy_name, text_for_encoding, key);
+      data_view.has_error = false;
     } catch (const std::exception &e) {
       data_view.output_text = e.what();
+      data_view.has_error = true;
     }
+    record(crypto_strategy_name, text_for_encoding.size(), start);
   }
 
   void decrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_decoding,
                const char *key) override {
+    const auto start { stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {} };
     try {
       try_decrypt(crypto_strategy_name, text_for_decoding, key);
+      data_view.has_error = false;
     } catch (const std::exception &e) {
       data_view.output_text = e.what();
+      data_view.has_error = true;
     }
+    record(crypto_strategy_name, text_for_decoding.size(), start);
   }
 
+  // Null disables the stats, which then cost one branch per call.
+  void set_stats(CryptoStats *stats) noexcept { this->stats = stats; }
+
  private:
+  void record(std::string_view crypto_strategy_name, std::size_t input_size,
+              std::chrono::steady_clock::time_point start) noexcept {
+    if (stats) {
+      stats->record(crypto_strategy_name, input_size, data_view.has_error ? 0 : data_view.output_text.size(),
+                    std::chrono::steady_clock::now() - start, data_view.has_error);
+    }
+  }
+
   void try_encrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_encoding,
                    const char *key) {
+    const TraceSpan span { "input.encrypt" };
     auto &strategy { get_strategy(crypto_strategy_name) };
     if (strategy.is_key_numeric()) {
       encrypt_when_numeric_key(strategy, text_for_encoding, key);
@@ -52,20 +83,27 @@ class CryptoInput : public Input {
     }
   }
 
-  CryptoStrategy &get_strategy(const std::string_view &crypto_strategy_name) {
-    return *crypto_strategies[crypto_strategy_name];
+  // Looks up without inserting, the registry is shared.
+  CryptoStrategy &get_strategy(const std::string_view &crypto_strategy_name) const {
+    const auto it { crypto_strategies->find(crypto_strategy_name) };
+    if (it == crypto_strategies->end()) {
+      throw_exception(unknown_crypto_strategy_error);
+    }
+
+    return *it->second;
   }
 
   void encrypt_when_numeric_key(CryptoStrategy &strategy, const std::string &text_for_encoding, const char *key) {
-    data_view.output_text = strategy.encrypt(text_for_encoding, std::stoi(key));
+    store_output(strategy.encrypt(text_for_encoding, std::stoi(key)));
   }
 
   void encrypt_when_non_numeric_key(CryptoStrategy &strategy, const std::string &text_for_encoding, const char *key) {
-    data_view.output_text = strategy.encrypt(text_for_encoding, key);
+    store_output(strategy.encrypt(text_for_encoding, key));
   }
 
   void try_decrypt(const std::string_view &crypto_strategy_name, const std::string &text_for_decoding,
                    const char *key) {
+    const TraceSpan span { "input.decrypt" };
     auto &strategy { get_strategy(crypto_strategy_name) };
     if (strategy.is_key_numeric()) {
       decrypt_when_numeric_key(strategy, text_for_decoding, key);
@@ -75,15 +113,21 @@ class CryptoInput : public Input {
   }
 
   void decrypt_when_numeric_key(CryptoStrategy &strategy, const std::string &text_for_decoding, const char *key) {
-    data_view.output_text = strategy.decrypt(text_for_decoding, std::stoi(key));
+    store_output(strategy.decrypt(text_for_decoding, std::stoi(key)));
   }
 
   void decrypt_when_non_numeric_key(CryptoStrategy &strategy, const std::string &text_for_decoding, const char *key) {
-    data_view.output_text = strategy.decrypt(text_for_decoding, key);
+    store_output(strategy.decrypt(text_for_decoding, key));
+  }
+
+  void store_output(std::string &&output) {
+    const TraceSpan span { "input.store_output" };
+    data_view.output_text = std::move(output);
   }
 
   DataView &data_view;
-  CryptoStrategies crypto_strategies;
+  SharedCryptoStrategies crypto_strategies;
+  CryptoStats *stats {};
 };
 
 #endif
\ No newline at end of file
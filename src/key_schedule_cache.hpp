@@ -0,0 +1,115 @@
+#ifndef KEY_SCHEDULE_CACHE_HPP
+#define KEY_SCHEDULE_CACHE_HPP
+
+#include <cryptopp/misc.h>
+
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Bounded LRU cache of keyed cipher objects, so that repeated keys skip the key expansion. Schedule is any
+// default-constructible type with SetKey(const byte *, size_t), e.g. AES::Encryption. Not thread-safe, the owner locks
+// around it. Entries are found by a hash of the key bytes and confirmed by comparing the bytes, the cached key copy is
+// wiped on eviction and Crypto++ wipes the expanded schedule in its own destructor.
+template <class Schedule>
+class KeyScheduleCache {
+ public:
+  struct Stats {
+    std::size_t hits {};
+    std::size_t misses {};
+    std::size_t evictions {};
+  };
+
+  explicit KeyScheduleCache(std::size_t capacity = 16) : capacity { capacity == 0 ? 1 : capacity } {}
+
+  KeyScheduleCache(const KeyScheduleCache &) = delete;
+  KeyScheduleCache &operator=(const KeyScheduleCache &) = delete;
+
+  ~KeyScheduleCache() { clear(); }
+
+  // Returns the schedule for the key, expanding it on a miss. The reference stays valid until the key is evicted.
+  Schedule &get(std::string_view key) {
+    const auto hash { std::hash<std::string_view> {}(key) };
+    if (const auto it { find(hash, key) }; it != index.end()) {
+      ++stats.hits;
+      entries.splice(entries.begin(), entries, it->second);
+      return it->second->schedule;
+    }
+
+    ++stats.misses;
+    auto &entry { entries.emplace_front() };
+    try {
+      entry.schedule.SetKey(reinterpret_cast<const CryptoPP::byte *>(key.data()), key.size());
+    } catch (...) {
+      entries.pop_front();
+      throw;
+    }
+
+    entry.key = key;
+    entry.hash = hash;
+    index.emplace(hash, entries.begin());
+    if (entries.size() > capacity) {
+      erase(std::prev(entries.end()));
+    }
+    return entry.schedule;
+  }
+
+  // Returns true when the key was cached.
+  bool evict(std::string_view key) {
+    const auto it { find(std::hash<std::string_view> {}(key), key) };
+    if (it == index.end()) {
+      return false;
+    }
+
+    erase(it->second);
+    return true;
+  }
+
+  void clear() {
+    while (entries.empty() == false) {
+      erase(entries.begin());
+    }
+  }
+
+  std::size_t size() const noexcept { return entries.size(); }
+
+  const Stats &get_stats() const noexcept { return stats; }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::size_t hash {};
+    Schedule schedule;
+  };
+
+  using Entries = std::list<Entry>;
+  using Index = std::unordered_multimap<std::size_t, typename Entries::iterator>;
+
+  typename Index::iterator find(std::size_t hash, std::string_view key) {
+    auto [it, end] { index.equal_range(hash) };
+    while (it != end && it->second->key != key) {
+      ++it;
+    }
+    return it == end ? index.end() : it;
+  }
+
+  void erase(typename Entries::iterator entry) {
+    auto [it, end] { index.equal_range(entry->hash) };
+    while (it->second != entry) {
+      ++it;
+    }
+    index.erase(it);
+
+    CryptoPP::SecureWipeArray(entry->key.data(), entry->key.size());
+    entries.erase(entry);
+    ++stats.evictions;
+  }
+
+  std::size_t capacity;
+  Entries entries;
+  Index index;
+  Stats stats;
+};
+#endif
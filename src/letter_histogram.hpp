@@ -0,0 +1,125 @@
+#ifndef LETTER_HISTOGRAM_HPP
+#define LETTER_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "cpu_features.hpp"
+
+// Counts the latin letters of a text regardless of their case and compares the counts with English. Other chars are
+// not counted.
+class LetterHistogram {
+ public:
+  using Counts = std::array<std::uint64_t, 26>;
+
+  static constexpr std::array<double, 26> english_frequencies {
+    0.08167, 0.01492, 0.02782, 0.04253, 0.12702, 0.02228, 0.02015, 0.06094, 0.06966, 0.00153, 0.00772, 0.04025, 0.02406,
+    0.06749, 0.07507, 0.01929, 0.00095, 0.05987, 0.06327, 0.09056, 0.02758, 0.00978, 0.02360, 0.00150, 0.01974, 0.00074
+  };
+
+  // Adds to counts, so a text can be counted in chunks.
+  static void count(std::string_view text, Counts &counts) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_avx2()) {
+      count_avx2(text, counts);
+    } else {
+      count_sse2(text, counts);
+    }
+#else
+    count_scalar(text, counts);
+#endif
+  }
+
+  static Counts count(std::string_view text) noexcept {
+    Counts counts {};
+    count(text, counts);
+    return counts;
+  }
+
+  // How far the counts are from English once every letter is shifted back by shift, lower is closer.
+  static double chi_squared(const Counts &counts, int shift) noexcept {
+    std::uint64_t total {};
+    for (auto &&count : counts) {
+      total += count;
+    }
+
+    auto result { 0.0 };
+    for (auto letter { 0 }; letter < 26; ++letter) {
+      const auto expected { static_cast<double>(total) * english_frequencies[letter] };
+      const auto difference { static_cast<double>(counts[(letter + shift) % 26]) - expected };
+      result += difference * difference / expected;
+    }
+    return total == 0 ? 0.0 : result;
+  }
+
+  static void count_scalar(std::string_view text, Counts &counts) noexcept {
+    for (auto &&ch : text) {
+      const auto letter { static_cast<unsigned char>((ch | 32) - 'a') };
+      if (letter < 26) {
+        ++counts[letter];
+      }
+    }
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // One compare per letter and block of bytes. Lowercasing and subtracting 'a' puts exactly the letters into 0..25,
+  // the matches are summed in byte lanes and widened before they can overflow. Half of the letters are counted per
+  // pass over a block, so the sums stay in registers.
+  static void count_sse2(std::string_view text, Counts &counts) noexcept {
+    constexpr std::size_t block_size { 255 * 16 };
+    std::size_t i {};
+    for (; i + 16 <= text.size(); i += block_size) {
+      const auto end { std::min(text.size() / 16 * 16, i + block_size) };
+      for (auto first : { 0, 13 }) {
+        __m128i sums[13] {};
+        for (auto offset { i }; offset < end; offset += 16) {
+          const auto bytes { _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + offset)) };
+          const auto letters { _mm_sub_epi8(_mm_or_si128(bytes, _mm_set1_epi8(32)), _mm_set1_epi8('a')) };
+#pragma GCC unroll 13
+          for (auto letter { 0 }; letter < 13; ++letter) {
+            sums[letter] =
+                _mm_sub_epi8(sums[letter], _mm_cmpeq_epi8(letters, _mm_set1_epi8(static_cast<char>(first + letter))));
+          }
+        }
+        for (auto letter { 0 }; letter < 13; ++letter) {
+          const auto wide { _mm_sad_epu8(sums[letter], _mm_setzero_si128()) };
+          counts[first + letter] += _mm_cvtsi128_si64(wide) + _mm_extract_epi16(wide, 4);
+        }
+      }
+    }
+
+    count_scalar(text.substr(std::min(i, text.size() / 16 * 16)), counts);
+  }
+
+  __attribute__((target("avx2"))) static void count_avx2(std::string_view text, Counts &counts) noexcept {
+    constexpr std::size_t block_size { 255 * 32 };
+    std::size_t i {};
+    for (; i + 32 <= text.size(); i += block_size) {
+      const auto end { std::min(text.size() / 32 * 32, i + block_size) };
+      for (auto first : { 0, 13 }) {
+        __m256i sums[13] {};
+        for (auto offset { i }; offset < end; offset += 32) {
+          const auto bytes { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + offset)) };
+          const auto letters { _mm256_sub_epi8(_mm256_or_si256(bytes, _mm256_set1_epi8(32)), _mm256_set1_epi8('a')) };
+#pragma GCC unroll 13
+          for (auto letter { 0 }; letter < 13; ++letter) {
+            const auto matches { _mm256_cmpeq_epi8(letters, _mm256_set1_epi8(static_cast<char>(first + letter))) };
+            sums[letter] = _mm256_sub_epi8(sums[letter], matches);
+          }
+        }
+        for (auto letter { 0 }; letter < 13; ++letter) {
+          const auto wide { _mm256_sad_epu8(sums[letter], _mm256_setzero_si256()) };
+          counts[first + letter] += _mm256_extract_epi64(wide, 0) + _mm256_extract_epi64(wide, 1) +
+                                    _mm256_extract_epi64(wide, 2) + _mm256_extract_epi64(wide, 3);
+        }
+      }
+    }
+
+    count_sse2(text.substr(std::min(i, text.size() / 32 * 32)), counts);
+  }
+#endif
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+
+#include "errors.hpp"
+
+class MappedFile {
+ public:
+  enum class Access { READ, READ_WRITE };
+
+  MappedFile(const std::string &path, Access access) {
+    open_file(path, access == Access::READ ? O_RDONLY : O_RDWR);
+    map(file_size(), access);
+    advise(MADV_SEQUENTIAL);
+  }
+
+  // Creates a new file next to path, under a unique name only this process can open, and preallocates size bytes
+  // for writing. Nothing that was at that name is followed or truncated. The file is removed again unless replace
+  // moves it to its final path, so a failed write leaves nothing behind.
+  MappedFile(const std::string &path, std::size_t size) : created_path { path + ".XXXXXX" } {
+    descriptor = ::mkostemp(created_path.data(), O_CLOEXEC);
+    if (descriptor < 0) {
+      created_path.clear();
+      throw_exception(cannot_open_file_error);
+    }
+    if (::ftruncate(descriptor, size) != 0) {
+      close_file();
+      ::unlink(created_path.c_str());
+      throw_exception(cannot_map_file_error);
+    }
+
+    try {
+      map(size, Access::READ_WRITE);
+    } catch (...) {
+      ::unlink(created_path.c_str());
+      throw;
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    unmap();
+    if (final_size != size) {
+      static_cast<void>(::ftruncate(descriptor, final_size));
+    }
+
+    close_file();
+    if (created_path.empty() == false) {
+      ::unlink(created_path.c_str());
+    }
+  }
+
+  std::span<char> data() noexcept { return { address, size }; }
+
+  // The file is cut to this size once it is unmapped.
+  void set_final_size(std::size_t new_size) noexcept { final_size = new_size; }
+
+  // The permission bits of the file.
+  mode_t get_mode() {
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0) {
+      throw_exception(cannot_open_file_error);
+    }
+
+    return status.st_mode & 07777;
+  }
+
+  // Cuts a created file to its final size, gives it the mode and renames it over path in one step, whatever was at
+  // path stays intact until then.
+  void replace(const std::string &path, mode_t mode) {
+    unmap();
+    if (::ftruncate(descriptor, final_size) != 0 || ::fchmod(descriptor, mode) != 0 ||
+        ::rename(created_path.c_str(), path.c_str()) != 0) {
+      throw_exception(cannot_open_file_error);
+    }
+
+    size = final_size;
+    created_path.clear();
+  }
+
+ private:
+  void open_file(const std::string &path, int flags) {
+    descriptor = ::open(path.c_str(), flags | O_CLOEXEC);
+    if (descriptor < 0) {
+      throw_exception(cannot_open_file_error);
+    }
+  }
+
+  std::size_t file_size() {
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0) {
+      close_file();
+      throw_exception(cannot_open_file_error);
+    }
+
+    return status.st_size;
+  }
+
+  void map(std::size_t new_size, Access access) {
+    size = new_size;
+    final_size = new_size;
+    if (size == 0) {
+      return;
+    }
+
+    const auto protection { access == Access::READ ? PROT_READ : PROT_READ | PROT_WRITE };
+    auto *mapped { ::mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0) };
+    if (mapped == MAP_FAILED) {
+      close_file();
+      throw_exception(cannot_map_file_error);
+    }
+
+    address = static_cast<char *>(mapped);
+  }
+
+  void advise(int advice) noexcept {
+    if (address != nullptr) {
+      ::madvise(address, size, advice);
+    }
+  }
+
+  void unmap() noexcept {
+    if (address != nullptr) {
+      ::munmap(address, size);
+      address = nullptr;
+    }
+  }
+
+  void close_file() noexcept {
+    if (descriptor >= 0) {
+      ::close(descriptor);
+      descriptor = -1;
+    }
+  }
+
+  // Of a created file that has not replaced its final path yet.
+  std::string created_path;
+  int descriptor { -1 };
+  char *address {};
+  std::size_t size {};
+  std::size_t final_size {};
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef PARALLEL_RANGES_HPP
+#define PARALLEL_RANGES_HPP
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+class ParallelRanges {
+ public:
+  // Splits [0, size) into at most `threads` ranges aligned to `alignment` and no shorter than `min_range_size`, and
+  // calls process(begin, length) for each of them. The calling thread takes the first range, and any range whose
+  // thread can't be started. Once every range is done the first exception thrown by process is rethrown here.
+  static void run(std::size_t size, unsigned threads, std::size_t alignment, std::size_t min_range_size,
+                  const std::function<void(std::size_t, std::size_t)> &process) {
+    const auto ranges { std::clamp<std::size_t>(size / min_range_size, 1, std::max(threads, 1u)) };
+    const auto range_size { (size / ranges + alignment - 1) / alignment * alignment };
+
+    std::vector<std::exception_ptr> errors(ranges);
+    const auto process_range { [&process, &errors, range_size, size](std::size_t range) {
+      try {
+        const auto begin { range * range_size };
+        process(begin, std::min(range_size, size - begin));
+      } catch (...) {
+        errors[range] = std::current_exception();
+      }
+    } };
+
+    {
+      std::vector<std::jthread> workers;
+      workers.reserve(ranges - 1);
+      for (std::size_t range { 1 }; range * range_size < size; ++range) {
+        try {
+          workers.emplace_back(process_range, range);
+        } catch (const std::system_error &) {
+          process_range(range);
+        }
+      }
+
+      process_range(0);
+    }
+
+    for (const auto &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PREPARED_KEY_HPP
+#define PREPARED_KEY_HPP
+
+#include "errors.hpp"
+
+// A key parsed and validated once by CryptoStrategy::prepare_key. It may only be passed back to the strategy that
+// prepared it, the strategies check that through key_cast.
+class PreparedKey {
+ public:
+  virtual ~PreparedKey() = default;
+};
+
+// The key as the type its strategy prepares, or null when another strategy prepared it.
+template <class Key>
+const Key *try_key_cast(const PreparedKey &key) noexcept {
+  return dynamic_cast<const Key *>(&key);
+}
+
+// Throws foreign_key_error when another strategy prepared the key.
+template <class Key>
+const Key &key_cast(const PreparedKey &key) {
+  const auto *typed_key { try_key_cast<Key>(key) };
+  if (typed_key == nullptr) {
+    throw_exception(foreign_key_error);
+  }
+
+  return *typed_key;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef TEXT_CODEC_HPP
+#define TEXT_CODEC_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "base64_codec.hpp"
+#include "hex_codec.hpp"
+
+// How binary output, e.g. an AES ciphertext, is written as text. Raw keeps the bytes as they are, which halves the
+// size against hex but is only fit for files and pipes.
+enum class TextEncoding { RAW, HEX, BASE64 };
+
+inline constexpr std::array<std::string_view, 3> text_encodings_binds { "raw", "hex", "base64" };
+
+// One interface over the codecs for the strategies that take the encoding as a parameter.
+class TextCodec {
+ public:
+  explicit TextCodec(TextEncoding encoding = TextEncoding::HEX) noexcept : encoding { encoding } {}
+
+  static std::optional<TextEncoding> parse(std::string_view name) noexcept {
+    const auto it { std::ranges::find(text_encodings_binds, name) };
+    if (it == text_encodings_binds.end()) {
+      return std::nullopt;
+    }
+
+    return static_cast<TextEncoding>(it - text_encodings_binds.begin());
+  }
+
+  TextEncoding get_encoding() const noexcept { return encoding; }
+
+  // Bytes that encode into whole chars on their own: parts of one text can be encoded separately when all but the last
+  // one are multiples of it, and encoded parts that are multiples of get_encoded_group_size() decode separately.
+  std::size_t get_group_size() const noexcept { return encoding == TextEncoding::BASE64 ? 3 : 1; }
+
+  std::size_t get_encoded_group_size() const noexcept {
+    return encoding == TextEncoding::RAW ? 1 : encoding == TextEncoding::HEX ? 2 : 4;
+  }
+
+  std::size_t get_encoded_size(std::size_t size) const noexcept {
+    switch (encoding) {
+      case TextEncoding::RAW:
+        return size;
+      case TextEncoding::HEX:
+        return 2 * size;
+      case TextEncoding::BASE64:
+        return Base64Codec::get_encoded_size(size);
+    }
+    return size;
+  }
+
+  std::size_t get_max_decoded_size(std::size_t size) const noexcept {
+    switch (encoding) {
+      case TextEncoding::RAW:
+        return size;
+      case TextEncoding::HEX:
+        return size / 2;
+      case TextEncoding::BASE64:
+        return Base64Codec::get_max_decoded_size(size);
+    }
+    return size;
+  }
+
+  // Writes exactly get_encoded_size(size) chars.
+  void encode(const std::uint8_t *decoded, std::size_t size, char *encoded) const noexcept {
+    switch (encoding) {
+      case TextEncoding::RAW:
+        std::copy_n(decoded, size, reinterpret_cast<std::uint8_t *>(encoded));
+        break;
+      case TextEncoding::HEX:
+        HexCodec::encode(decoded, size, encoded);
+        break;
+      case TextEncoding::BASE64:
+        Base64Codec::encode(decoded, size, encoded);
+        break;
+    }
+  }
+
+  // Writes at most get_max_decoded_size(size) bytes and returns their count, nothing when the text is not in the
+  // encoding.
+  std::optional<std::size_t> decode(const char *encoded, std::size_t size, std::uint8_t *decoded) const noexcept {
+    switch (encoding) {
+      case TextEncoding::RAW:
+        std::copy_n(reinterpret_cast<const std::uint8_t *>(encoded), size, decoded);
+        return size;
+      case TextEncoding::HEX:
+        if (size % 2 != 0 || HexCodec::decode(encoded, size / 2, decoded) == false) {
+          return std::nullopt;
+        }
+        return size / 2;
+      case TextEncoding::BASE64:
+        return Base64Codec::decode(encoded, size, decoded);
+    }
+    return std::nullopt;
+  }
+
+ private:
+  TextEncoding encoding;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef TEXT_ROWS_HPP
+#define TEXT_ROWS_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Splits a text into rows at newlines and every max_row_length chars, once per text, so that a view can draw only the
+// visible rows. Long hex output has no newlines at all, hence the hard wrap.
+class TextRows {
+ public:
+  void build(std::string_view text, std::size_t max_row_length) {
+    rows.clear();
+    for (std::size_t offset {}; offset < text.size();) {
+      const auto rest { std::min(text.size() - offset, max_row_length) };
+      const auto *newline { static_cast<const char *>(std::memchr(text.data() + offset, '\n', rest)) };
+      if (newline == nullptr) {
+        rows.push_back({ offset, rest });
+        offset += rest;
+        // A newline right after a full row ends that row, it doesn't start an empty one.
+        if (offset < text.size() && text[offset] == '\n') {
+          ++offset;
+        }
+      } else {
+        const auto length { static_cast<std::size_t>(newline - text.data()) - offset };
+        rows.push_back({ offset, length });
+        offset += length + 1;
+      }
+    }
+  }
+
+  std::size_t size() const noexcept { return rows.size(); }
+
+  // The text must be the one the rows were built from.
+  std::string_view get_row(std::string_view text, std::size_t index) const noexcept {
+    return text.substr(rows[index].offset, rows[index].length);
+  }
+
+ private:
+  struct Row {
+    std::size_t offset;
+    std::size_t length;
+  };
+
+  std::vector<Row> rows;
+};
+
+#endif
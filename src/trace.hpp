@@ -0,0 +1,215 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceEvent {
+  const char *name;
+  std::uint64_t start_nanoseconds;
+  std::uint64_t duration_nanoseconds;
+};
+
+// Written only by the thread that owns it and read by the exporter, so neither side locks. Once full, the newest
+// events overwrite the oldest, so a long-running process keeps its recent history. The exporter copies the slots, then
+// discards the ones the writer may have started to overwrite during the copy.
+class TraceBuffer {
+ public:
+  static constexpr std::size_t capacity { 1 << 14 };
+
+  explicit TraceBuffer(std::uint32_t thread_id) : slots { new Slot[capacity] }, thread_id { thread_id } {}
+
+  void push(const TraceEvent &event) noexcept {
+    const auto index { started.load(std::memory_order_relaxed) };
+    started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto &slot { slots[index % capacity] };
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.start_nanoseconds.store(event.start_nanoseconds, std::memory_order_relaxed);
+    slot.duration_nanoseconds.store(event.duration_nanoseconds, std::memory_order_relaxed);
+    published.store(index + 1, std::memory_order_release);
+  }
+
+  // The events still held, oldest first.
+  std::vector<TraceEvent> get_events() const {
+    const auto end { published.load(std::memory_order_acquire) };
+    const auto begin { end - std::min(end, capacity) };
+    std::vector<TraceEvent> events;
+    events.reserve(end - begin);
+    for (auto index { begin }; index < end; ++index) {
+      const auto &slot { slots[index % capacity] };
+      events.push_back({ slot.name.load(std::memory_order_relaxed),
+                         slot.start_nanoseconds.load(std::memory_order_relaxed),
+                         slot.duration_nanoseconds.load(std::memory_order_relaxed) });
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto overwritten { started.load(std::memory_order_relaxed) };
+    const auto first_intact { std::max(begin, overwritten - std::min(overwritten, capacity)) };
+    events.erase(events.begin(), events.begin() + std::min(first_intact - begin, events.size()));
+    return events;
+  }
+
+  // The events that were overwritten, counted as if the exporter had come just now.
+  std::uint64_t get_dropped() const noexcept {
+    const auto size { published.load(std::memory_order_relaxed) };
+    return size - std::min(size, capacity);
+  }
+
+  std::uint32_t get_thread_id() const noexcept { return thread_id; }
+
+  void clear() noexcept {
+    started.store(0, std::memory_order_relaxed);
+    published.store(0, std::memory_order_relaxed);
+  }
+
+  std::atomic<bool> is_owned {};
+
+ private:
+  struct Slot {
+    std::atomic<const char *> name;
+    std::atomic<std::uint64_t> start_nanoseconds;
+    std::atomic<std::uint64_t> duration_nanoseconds;
+  };
+
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<std::size_t> started {};
+  std::atomic<std::size_t> published {};
+  std::uint32_t thread_id;
+};
+
+// Collects spans from every thread and exports them as Chrome trace-event JSON, which opens in Perfetto or
+// chrome://tracing. Disabled it costs a relaxed load per span. A thread takes a buffer on its first span and hands it
+// back on exit, the next new thread reuses it, so short-lived workers don't grow the memory.
+class Tracer {
+ public:
+  static Tracer &get_instance() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  void set_enabled(bool is_enabled) noexcept { this->is_enabled.store(is_enabled, std::memory_order_relaxed); }
+
+  bool get_is_enabled() const noexcept { return is_enabled.load(std::memory_order_relaxed); }
+
+  void record(const char *name, std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end) {
+    get_thread_buffer().push({ name, to_nanoseconds(start - epoch), to_nanoseconds(end - start) });
+  }
+
+  std::string to_json() const {
+    std::lock_guard lock { buffers_mutex };
+
+    std::string json { "{\"traceEvents\":[" };
+    std::uint64_t dropped {};
+    auto is_first { true };
+    for (auto &&buffer : buffers) {
+      for (auto &&event : buffer->get_events()) {
+        json += is_first ? "" : ",";
+        append_event(json, event, buffer->get_thread_id());
+        is_first = false;
+      }
+      dropped += buffer->get_dropped();
+    }
+    json += "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" + std::to_string(dropped) + "}}";
+    return json;
+  }
+
+  // Only while no thread is recording, e.g. between tests.
+  void clear() {
+    std::lock_guard lock { buffers_mutex };
+    for (auto &&buffer : buffers) {
+      buffer->clear();
+    }
+  }
+
+ private:
+  Tracer() = default;
+
+  class BufferOwner {
+   public:
+    ~BufferOwner() {
+      if (buffer) {
+        buffer->is_owned.store(false, std::memory_order_release);
+      }
+    }
+
+    TraceBuffer *buffer {};
+  };
+
+  TraceBuffer &get_thread_buffer() {
+    thread_local BufferOwner owner;
+    if (owner.buffer == nullptr) {
+      owner.buffer = &acquire_buffer();
+    }
+
+    return *owner.buffer;
+  }
+
+  TraceBuffer &acquire_buffer() {
+    std::lock_guard lock { buffers_mutex };
+    for (auto &&buffer : buffers) {
+      if (buffer->is_owned.exchange(true, std::memory_order_acquire) == false) {
+        return *buffer;
+      }
+    }
+
+    auto &buffer { *buffers.emplace_back(std::make_unique<TraceBuffer>(static_cast<std::uint32_t>(buffers.size()))) };
+    buffer.is_owned = true;
+    return buffer;
+  }
+
+  static std::uint64_t to_nanoseconds(std::chrono::steady_clock::duration duration) noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+  }
+
+  // Complete events, timestamps are microseconds with nanosecond decimals.
+  static void append_event(std::string &json, const TraceEvent &event, std::uint32_t thread_id) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\",\"cat\":\"crypto\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                  event.start_nanoseconds / 1000.0, event.duration_nanoseconds / 1000.0, thread_id);
+    json += "{\"name\":\"";
+    json += event.name;
+    json += buffer;
+  }
+
+  const std::chrono::steady_clock::time_point epoch { std::chrono::steady_clock::now() };
+  std::atomic<bool> is_enabled {};
+
+  mutable std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+// Times the scope it lives in, the name must outlive the tracer, e.g. a string literal.
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char *name) noexcept : name { Tracer::get_instance().get_is_enabled() ? name : nullptr } {
+    if (this->name) {
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+  ~TraceSpan() {
+    if (name) {
+      Tracer::get_instance().record(name, start, std::chrono::steady_clock::now());
+    }
+  }
+
+ private:
+  const char *name;
+  std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef VIGENERE_CRACKER_HPP
+#define VIGENERE_CRACKER_HPP
+
+#include <algorithm>
+#include <any>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "crack_result.hpp"
+#include "errors.hpp"
+#include "letter_histogram.hpp"
+#include "parallel_ranges.hpp"
+#include "vigenere_crypto.hpp"
+
+// Recovers the key of a Vigenère ciphertext of English text. Only the letters take part, like in the cipher, where
+// skipped chars don't move the key. The key length is the one at which the letters coincide with themselves shifted
+// by it about as often as English letters do, backed by the distances between repeated 4-grams (Kasiski). Every key
+// letter is then the shift that brings the letters of its column closest to the English frequencies.
+class VigenereCracker {
+ public:
+  static constexpr std::size_t max_key_length { 40 };
+  // Fewer letters per column say too little about the frequencies.
+  static constexpr std::size_t min_column_length { 8 };
+  // Kasiski looks at the start of long texts only, more repeats don't change the picture.
+  static constexpr std::size_t kasiski_window { 1 << 18 };
+
+  explicit VigenereCracker(unsigned threads = std::thread::hardware_concurrency()) : threads { threads } {}
+
+  // The plain text comes from VigenereCryptoStrategy, which throws for texts it can't decrypt.
+  CrackResult crack(const std::string &text, const std::stop_token &stop_token = {}) const {
+    auto key { find_key(text, stop_token) };
+    throw_if_stop_requested(stop_token);
+    auto plain_text { VigenereCryptoStrategy {}.decrypt(text, std::any { key.c_str() }) };
+    return { std::move(key), std::move(plain_text) };
+  }
+
+  // In the case of the text, which the strategy requires. Throws when the text has too few letters.
+  std::string find_key(std::string_view text, const std::stop_token &stop_token = {}) const {
+    const auto letters { extract_letters(text) };
+    throw_if_stop_requested(stop_token);
+    auto key { reduce_to_period(solve_columns(letters, estimate_key_length(letters, stop_token), stop_token)) };
+    if (const auto first { std::ranges::find_if(text, CharClasses::is_letter) };
+        first != text.end() && CharClasses::of(*first) == CharClasses::UPPER) {
+      std::ranges::transform(key, key.begin(), [](char ch) { return static_cast<char>(ch - 'a' + 'A'); });
+    }
+    return key;
+  }
+
+  // Lowercase letters only, the rest of the text is dropped.
+  static std::string extract_letters(std::string_view text) {
+    std::string letters;
+    letters.reserve(text.size());
+    for (auto &&ch : text) {
+      if (CharClasses::is_letter(ch)) {
+        letters += static_cast<char>(ch | 32);
+      }
+    }
+    return letters;
+  }
+
+  // Multiples of the key length score about as high as the length itself, so the shortest of the near best lengths
+  // wins. The lengths are scored in parallel.
+  std::size_t estimate_key_length(std::string_view letters, const std::stop_token &stop_token = {}) const {
+    const auto max_length { std::min(max_key_length, letters.size() / min_column_length) };
+    if (max_length == 0) {
+      throw_exception(not_enough_letters_error);
+    }
+
+    std::vector<double> scores(max_length + 1);
+    ParallelRanges::run(max_length, threads, 1, 1, [&](std::size_t begin, std::size_t length) {
+      for (auto key_length { begin + 1 }; key_length <= begin + length && stop_token.stop_requested() == false;
+           ++key_length) {
+        scores[key_length] = get_coincidence_score(letters, key_length);
+      }
+    });
+    throw_if_stop_requested(stop_token);
+    add_kasiski_scores(letters.substr(0, kasiski_window), scores);
+
+    const auto best { *std::ranges::max_element(scores.begin() + 1, scores.end()) };
+    std::size_t key_length { 1 };
+    while (scores[key_length] < best - near_best_margin) {
+      ++key_length;
+    }
+    return key_length;
+  }
+
+  // Every column is histogrammed and gets the shift with the smallest chi-squared.
+  static std::string solve_columns(std::string_view letters, std::size_t key_length,
+                                   const std::stop_token &stop_token = {}) {
+    std::vector<std::string> columns(key_length);
+    for (auto &&column : columns) {
+      column.reserve(letters.size() / key_length + 1);
+    }
+    for (std::size_t i {}, column {}; i < letters.size(); ++i) {
+      columns[column] += letters[i];
+      column = column + 1 == key_length ? 0 : column + 1;
+    }
+
+    std::string key;
+    for (auto &&column : columns) {
+      throw_if_stop_requested(stop_token);
+      const auto counts { LetterHistogram::count(column) };
+      auto best_shift { 0 };
+      for (auto shift { 1 }; shift < 26; ++shift) {
+        if (LetterHistogram::chi_squared(counts, shift) < LetterHistogram::chi_squared(counts, best_shift)) {
+          best_shift = shift;
+        }
+      }
+      key += static_cast<char>('a' + best_shift);
+    }
+    return key;
+  }
+
+  // A key made of repeats of a shorter key encrypts the same, e.g. a length estimated as a multiple of the real one.
+  static std::string reduce_to_period(const std::string &key) {
+    for (std::size_t period { 1 }; period < key.size(); ++period) {
+      if (key.size() % period == 0 && key.substr(period) == key.substr(0, key.size() - period)) {
+        return key.substr(0, period);
+      }
+    }
+    return key;
+  }
+
+  // How many letters equal the letter shift places further.
+  static std::size_t count_coincidences(std::string_view letters, std::size_t shift) noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    return CpuFeatures::has_avx2() ? count_coincidences_avx2(letters, shift) : count_coincidences_sse2(letters, shift);
+#else
+    return count_coincidences_scalar(letters, shift);
+#endif
+  }
+
+  static std::size_t count_coincidences_scalar(std::string_view letters, std::size_t shift) noexcept {
+    std::size_t result {};
+    for (auto i { shift }; i < letters.size(); ++i) {
+      result += letters[i] == letters[i - shift];
+    }
+    return result;
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // The matches are summed in byte lanes and widened before they can overflow.
+  static std::size_t count_coincidences_sse2(std::string_view letters, std::size_t shift) noexcept {
+    constexpr std::size_t block_size { 255 * 16 };
+    std::size_t result {};
+    auto i { shift };
+    while (i + 16 <= letters.size()) {
+      const auto end { std::min(i + block_size, letters.size() - (letters.size() - i) % 16) };
+      auto sums { _mm_setzero_si128() };
+      for (; i < end; i += 16) {
+        const auto ahead { _mm_loadu_si128(reinterpret_cast<const __m128i *>(letters.data() + i)) };
+        const auto behind { _mm_loadu_si128(reinterpret_cast<const __m128i *>(letters.data() + i - shift)) };
+        sums = _mm_sub_epi8(sums, _mm_cmpeq_epi8(ahead, behind));
+      }
+      const auto wide { _mm_sad_epu8(sums, _mm_setzero_si128()) };
+      result += _mm_cvtsi128_si64(wide) + _mm_extract_epi16(wide, 4);
+    }
+
+    return result + count_coincidences_scalar(letters.substr(i - shift), shift);
+  }
+
+  __attribute__((target("avx2"))) static std::size_t count_coincidences_avx2(std::string_view letters,
+                                                                             std::size_t shift) noexcept {
+    constexpr std::size_t block_size { 255 * 32 };
+    std::size_t result {};
+    auto i { shift };
+    while (i + 32 <= letters.size()) {
+      const auto end { std::min(i + block_size, letters.size() - (letters.size() - i) % 32) };
+      auto sums { _mm256_setzero_si256() };
+      for (; i < end; i += 32) {
+        const auto ahead { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(letters.data() + i)) };
+        const auto behind { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(letters.data() + i - shift)) };
+        sums = _mm256_sub_epi8(sums, _mm256_cmpeq_epi8(ahead, behind));
+      }
+      const auto wide { _mm256_sad_epu8(sums, _mm256_setzero_si256()) };
+      result += _mm256_extract_epi64(wide, 0) + _mm256_extract_epi64(wide, 1) + _mm256_extract_epi64(wide, 2) +
+                _mm256_extract_epi64(wide, 3);
+    }
+
+    return result + count_coincidences_scalar(letters.substr(i - shift), shift);
+  }
+#endif
+
+ private:
+  // Chances that two letters are the same, in English text and in uniformly random letters.
+  static constexpr auto english_coincidence { 0.0667 };
+  static constexpr auto random_coincidence { 1.0 / 26 };
+  static constexpr auto near_best_margin { 0.25 };
+
+  // About 1 when the letters a key length apart coincide like English, about 0 when they look random.
+  static double get_coincidence_score(std::string_view letters, std::size_t key_length) noexcept {
+    const auto rate { static_cast<double>(count_coincidences(letters, key_length)) /
+                      static_cast<double>(letters.size() - key_length) };
+    return (rate - random_coincidence) / (english_coincidence - random_coincidence);
+  }
+
+  // Repeated 4-grams are mostly the same plain text under the same key letters, so their distances tend to be
+  // multiples of the key length. A length gets the share of distances it divides beyond the share chance gives it.
+  static void add_kasiski_scores(std::string_view letters, std::vector<double> &scores) {
+    constexpr std::size_t grams_count { 26 * 26 * 26 * 26 };
+    std::vector<std::uint32_t> last_ends(grams_count);
+    std::vector<std::uint32_t> distances_counts(letters.size());
+    std::size_t repeats_count {};
+    std::size_t gram {};
+    for (std::size_t i {}; i < letters.size(); ++i) {
+      gram = (gram * 26 + static_cast<std::size_t>(letters[i] - 'a')) % grams_count;
+      if (i < 3) {
+        continue;
+      }
+
+      // Ends are stored plus one, so zero marks a 4-gram that wasn't seen yet.
+      if (const auto last_end { last_ends[gram] }) {
+        ++distances_counts[i + 1 - last_end];
+        ++repeats_count;
+      }
+      last_ends[gram] = static_cast<std::uint32_t>(i + 1);
+    }
+
+    if (repeats_count == 0) {
+      return;
+    }
+
+    for (std::size_t key_length { 1 }; key_length < scores.size(); ++key_length) {
+      std::size_t divided_count {};
+      for (auto distance { key_length }; distance < distances_counts.size(); distance += key_length) {
+        divided_count += distances_counts[distance];
+      }
+      scores[key_length] += static_cast<double>(divided_count) / static_cast<double>(repeats_count) -
+                            1.0 / static_cast<double>(key_length);
+    }
+  }
+
+  unsigned threads;
+};
+
+#endif
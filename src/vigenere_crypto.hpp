@@ -1,146 +1,241 @@
 #ifndef VIGENERE_CRYPTO_HPP
 #define VIGENERE_CRYPTO_HPP
 
-#include <cctype>
-#include <functional>
-#include <stdexcept>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "crypto_strategy.hpp"
 #include "errors.hpp"
+#include "vigenere_kernel.hpp"
 
 class KeyParser {
  public:
-  std::string parse(const std::string &text, const std::any &any) {
+  static std::string_view parse(const std::string &text, const std::any &any) {
     const auto key { extract_key(any) };
-    check_key(text, key);
-    return match_key_to_text(text, key);
+    check_length(text.length(), key.length());
+    check_chars(key);
+    return key;
   }
 
- private:
-  std::string extract_key(const std::any &any) { return std::any_cast<const char *>(any); }
+  static std::string_view extract_key(const std::any &any) { return std::any_cast<const char *>(any); }
 
-  void check_key(const std::string &text, const std::string &key) {
-    if (text.length() < key.length()) {
+  static void check_length(std::size_t text_length, std::size_t key_length) {
+    if (is_length_valid(text_length, key_length) == false) {
       throw_exception(key_longer_than_text_error);
     }
+  }
+
+  static bool is_length_valid(std::size_t text_length, std::size_t key_length) noexcept {
+    return text_length >= key_length;
+  }
+
+  static void check_chars(std::string_view key) {
+    if (key.empty()) {
+      throw_exception(key_is_empty_error);
+    }
 
     for (auto &&ch : key) {
-      if (std::isalpha(ch) == false) {
+      if (CharClasses::is_letter(ch) == false) {
         throw_exception(key_contains_non_alphabetic_chars_error);
       }
     }
   }
+};
 
-  std::string match_key_to_text(const std::string &text, const std::string &key) {
-    const auto text_length { text.length() };
-    const auto key_length { key.length() };
+class VigenereStatus {
+ public:
+  static void check(VigenereKernel::Status status) {
+    if (const auto error { get_error(status) }) {
+      throw_exception(error);
+    }
+  }
 
-    std::string result;
+  // Null when the status is OK.
+  static ErrorCode get_error(VigenereKernel::Status status) noexcept {
+    if (status == VigenereKernel::Status::CASE_IS_DIFFERENT) {
+      return case_is_different_error;
+    } else if (status == VigenereKernel::Status::BROKEN_TEXT) {
+      return broken_text_error;
+    }
 
-    for (int i = 0, j = 0; i < text_length; ++i) {
-      const char text_ch { text[i] };
-      if (std::isspace(text_ch) || std::ispunct(text_ch)) {
-        result += text_ch;
-      } else {
-        result += key[j++ % key_length];
-      }
+    return nullptr;
+  }
+};
+
+// The output is held back until the text is at least as long as the key, so a text too short for the key fails
+// before any of it is written.
+class VigenereCryptoStream : public CryptoStream {
+ public:
+  explicit VigenereCryptoStream(bool is_encryption) : is_encryption { is_encryption } {}
+
+  void begin(const std::any &any) override {
+    key = KeyParser::extract_key(any);
+    KeyParser::check_chars(key);
+
+    kernel.emplace(is_encryption ? VigenereKernel::for_encryption(key) : VigenereKernel::for_decryption(key));
+    state = {};
+    text_length = 0;
+    held_output.clear();
+  }
+
+  std::string update(const std::string &chunk) override {
+    std::string result(chunk.size(), '\0');
+    VigenereStatus::check(kernel->transform(chunk.data(), result.data(), chunk.size(), state));
+    text_length += chunk.size();
+    if (held_output.empty() && KeyParser::is_length_valid(text_length, key.length())) {
+      return result;
     }
 
-    return result;
+    held_output += result;
+    return KeyParser::is_length_valid(text_length, key.length()) ? std::exchange(held_output, {}) : std::string {};
+  }
+
+  std::string finish() override {
+    KeyParser::check_length(text_length, key.length());
+    return {};
   }
+
+ private:
+  bool is_encryption;
+  std::string key;
+  std::optional<VigenereKernel> kernel;
+  VigenereKernel::State state;
+  std::size_t text_length {};
+  std::string held_output;
+};
+
+// Owns the key letters the kernels refer to, so it can't be copied. The letters must already be checked.
+class VigenereKey : public PreparedKey {
+ public:
+  explicit VigenereKey(std::string_view letters)
+      : letters { letters },
+        encryption { VigenereKernel::for_encryption(this->letters) },
+        decryption { VigenereKernel::for_decryption(this->letters) } {}
+
+  VigenereKey(const VigenereKey &) = delete;
+  VigenereKey &operator=(const VigenereKey &) = delete;
+
+  const std::string letters;
+  const VigenereKernel encryption;
+  const VigenereKernel decryption;
 };
 
 class VigenereCryptoStrategy : public CryptoStrategy {
  public:
   std::string encrypt(const std::string &text_for_encoding, const std::any &any) override {
-    return parse(text_for_encoding, key_parser.parse(text_for_encoding, any),
-                 [this](auto text_ch, auto key_ch) { return encrypt_char(text_ch, key_ch); });
+    return parse(text_for_encoding, VigenereKernel::for_encryption(KeyParser::parse(text_for_encoding, any)));
   }
 
   std::string decrypt(const std::string &text_for_decoding, const std::any &any) override {
-    return parse(text_for_decoding, key_parser.parse(text_for_decoding, any),
-                 [this](auto text_ch, auto key_ch) { return decrypt_char(text_ch, key_ch); });
+    return parse(text_for_decoding, VigenereKernel::for_decryption(KeyParser::parse(text_for_decoding, any)));
   }
 
-  bool is_key_numeric() noexcept override { return false; }
-
- private:
-  std::string parse(const std::string &text_for_encoding, const std::string &key,
-                    std::function<char(char, char)> policy) {
-    check_case(text_for_encoding);
-    check_case(key);
+  std::unique_ptr<PreparedKey> prepare_key(const char *key) override {
+    KeyParser::check_chars(key);
+    return std::make_unique<VigenereKey>(key);
+  }
 
-    const auto text_length { text_for_encoding.length() };
-    std::string result;
+  // Only the length of the text is left to check per call.
+  std::string encrypt(const std::string &text_for_encoding, const PreparedKey &key) override {
+    const auto &vigenere_key { key_cast<VigenereKey>(key) };
+    KeyParser::check_length(text_for_encoding.length(), vigenere_key.letters.length());
+    return parse(text_for_encoding, vigenere_key.encryption);
+  }
 
-    for (int i = 0; i < text_length; ++i) {
-      result += parse_character(text_for_encoding[i], key[i], policy);
-    }
+  std::string decrypt(const std::string &text_for_decoding, const PreparedKey &key) override {
+    const auto &vigenere_key { key_cast<VigenereKey>(key) };
+    KeyParser::check_length(text_for_decoding.length(), vigenere_key.letters.length());
+    return parse(text_for_decoding, vigenere_key.decryption);
+  }
 
-    return result;
+  std::size_t encrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_encrypt_into(in, out, key));
   }
 
-  void check_case(const std::string &str) {
-    const auto is_total_uppercase { std::isupper(str[0]) > 0 };
+  std::size_t decrypt_into(std::span<const std::byte> in, std::span<std::byte> out, const PreparedKey &key) override {
+    return or_throw(try_decrypt_into(in, out, key));
+  }
 
-    for (auto &&ch : str) {
-      compare_ch_case(ch, is_total_uppercase);
+  SizeOrError try_encrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const auto *vigenere_key { try_key_cast<VigenereKey>(key) };
+    if (vigenere_key == nullptr) {
+      return std::unexpected { foreign_key_error };
     }
+
+    return try_transform(in, out, *vigenere_key, true);
   }
 
-  void compare_ch_case(const char ch, const bool is_total_uppercase) {
-    if (std::ispunct(ch) || std::isspace(ch)) {
-      return;
+  SizeOrError try_decrypt_into(std::span<const std::byte> in, std::span<std::byte> out,
+                               const PreparedKey &key) noexcept override {
+    const auto *vigenere_key { try_key_cast<VigenereKey>(key) };
+    if (vigenere_key == nullptr) {
+      return std::unexpected { foreign_key_error };
     }
 
-    const auto is_ch_uppercase { std::isupper(ch) > 0 };
-    if (is_total_uppercase != is_ch_uppercase) {
-      throw_exception(case_is_different_error);
-    }
+    return try_transform(in, out, *vigenere_key, false);
   }
 
-  char parse_character(const char text_ch, const char key_ch, std::function<char(char, char)> policy) {
-    if (std::ispunct(text_ch) || std::isspace(text_ch)) {
-      return text_ch;
-    } else {
-      return policy(text_ch, key_ch);
-    }
+  // The kernels allow in and out to alias. On error the text is left partially transformed.
+  void encrypt_in_place(std::span<std::byte> text, const PreparedKey &key) {
+    transform(text.data(), text.data(), text.size(), key_cast<VigenereKey>(key), true);
   }
 
-  char encrypt_char(char text_ch, char key_ch) {
-    if (text_ch >= 'a' && text_ch <= 'z') {
-      const auto encrypted { ((text_ch - 'a') + (key_ch - 'a')) % 26 + 'a' };
-      return check_encrypt_boundary_lower_case(encrypted);
-    } else if (text_ch >= 'A' && text_ch <= 'Z') {
-      const auto encrypted { ((text_ch - 'A') + (key_ch - 'A')) % 26 + 'A' };
-      return check_encrypt_boundary_upper_case(encrypted);
-    } else {
-      throw_exception(broken_text_error);
-    }
+  void decrypt_in_place(std::span<std::byte> text, const PreparedKey &key) {
+    transform(text.data(), text.data(), text.size(), key_cast<VigenereKey>(key), false);
   }
 
-  char check_encrypt_boundary_lower_case(char encrypted) { return encrypted > 'z' ? encrypted - 26 : encrypted; }
+  bool is_key_numeric() noexcept override { return false; }
 
-  char check_encrypt_boundary_upper_case(char encrypted) { return encrypted > 'Z' ? encrypted - 26 : encrypted; }
+  std::size_t max_encrypted_size(std::size_t text_size) noexcept override { return text_size; }
 
-  char decrypt_char(char text_ch, char key_ch) {
-    if (text_ch >= 'a' && text_ch <= 'z') {
-      const auto decrypted { ((text_ch - 'a') - (key_ch - 'a')) % 26 + 'a' };
-      return check_decrypt_boundary_lower_case(decrypted);
-    } else if (text_ch >= 'A' && text_ch <= 'Z') {
-      const auto decrypted { ((text_ch - 'A') - (key_ch - 'A')) % 26 + 'A' };
-      return check_decrypt_boundary_upper_case(decrypted);
-    } else {
-      throw_exception(broken_text_error);
-    }
+  std::size_t max_decrypted_size(std::size_t text_size) noexcept override { return text_size; }
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<VigenereCryptoStream>(true);
+  }
+
+  std::unique_ptr<CryptoStream> create_decryption_stream() override {
+    return std::make_unique<VigenereCryptoStream>(false);
+  }
+
+ private:
+  std::string parse(const std::string &text, const VigenereKernel &kernel) {
+    std::string result(text.size(), '\0');
+    VigenereKernel::State state;
+    VigenereStatus::check(kernel.transform(text.data(), result.data(), text.size(), state));
+    return result;
   }
 
-  char check_decrypt_boundary_lower_case(char decrypted) { return decrypted < 'a' ? decrypted + 26 : decrypted; }
+  static void transform(const void *in, void *out, std::size_t size, const VigenereKey &key, bool is_encryption) {
+    KeyParser::check_length(size, key.letters.length());
 
-  char check_decrypt_boundary_upper_case(char decrypted) { return decrypted < 'A' ? decrypted + 26 : decrypted; }
+    const auto &kernel { is_encryption ? key.encryption : key.decryption };
+    VigenereKernel::State state;
+    VigenereStatus::check(kernel.transform(static_cast<const char *>(in), static_cast<char *>(out), size, state));
+  }
+
+  static SizeOrError try_transform(std::span<const std::byte> in, std::span<std::byte> out, const VigenereKey &key,
+                                   bool is_encryption) noexcept {
+    if (out.size() < in.size()) {
+      return std::unexpected { output_buffer_is_too_small_error };
+    }
+    if (KeyParser::is_length_valid(in.size(), key.letters.length()) == false) {
+      return std::unexpected { key_longer_than_text_error };
+    }
 
-  KeyParser key_parser;
+    const auto &kernel { is_encryption ? key.encryption : key.decryption };
+    VigenereKernel::State state;
+    const auto *text { reinterpret_cast<const char *>(in.data()) };
+    const auto status { kernel.transform(text, reinterpret_cast<char *>(out.data()), in.size(), state) };
+    if (const auto error { VigenereStatus::get_error(status) }) {
+      return std::unexpected { error };
+    }
+
+    return in.size();
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,197 @@
+#ifndef VIGENERE_KERNEL_HPP
+#define VIGENERE_KERNEL_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <string_view>
+
+#include "char_classes.hpp"
+#include "cpu_features.hpp"
+
+// Single pass over the text with a cyclic key cursor: skipped chars keep the cursor in place, the case of the text
+// and of the used key chars is checked on the way. Case errors win over broken chars, like in the old multi-pass
+// code that checked the case of the whole text before transforming it.
+class VigenereKernel {
+ public:
+  enum class Status { OK, BROKEN_TEXT, CASE_IS_DIFFERENT };
+
+  // Carried between calls so a message can be transformed in chunks.
+  struct State {
+    std::size_t key_position {};
+    bool is_started {};
+    bool is_text_uppercase {};
+    bool is_key_uppercase {};
+  };
+
+  // The key must be non-empty and alphabetic, it is referenced and not copied.
+  static VigenereKernel for_encryption(std::string_view key) noexcept { return { key, true }; }
+
+  static VigenereKernel for_decryption(std::string_view key) noexcept { return { key, false }; }
+
+  // Writes size chars to out, which may alias in.
+  Status transform(const char *in, char *out, std::size_t size, State &state) const noexcept {
+#ifdef CRYPTO_X86_KERNELS
+    if (CpuFeatures::has_ssse3()) {
+      return transform_ssse3(in, out, size, state);
+    }
+#endif
+    return transform_scalar(in, out, size, state);
+  }
+
+  Status transform_scalar(const char *in, char *out, std::size_t size, State &state) const noexcept {
+    auto is_broken { false };
+    for (std::size_t i {}; i < size; ++i) {
+      const auto status { transform_char(in[i], out[i], state) };
+      if (status == Status::CASE_IS_DIFFERENT) {
+        return status;
+      }
+      is_broken |= status == Status::BROKEN_TEXT;
+    }
+
+    return is_broken ? Status::BROKEN_TEXT : Status::OK;
+  }
+
+#ifdef CRYPTO_X86_KERNELS
+  // Blocks of letters and skipped chars are transformed in registers: a prefix sum over the letter mask gives every
+  // letter its key offset, which picks the shift from the repeated key with a byte shuffle. Blocks that need a
+  // diagnosis go through the scalar path.
+  __attribute__((target("ssse3"))) Status transform_ssse3(const char *in, char *out, std::size_t size,
+                                                           State &state) const noexcept {
+    auto is_broken { false };
+    std::size_t i {};
+
+    if (size > 0 && state.is_started == false) {
+      is_broken |= transform_char(in[0], out[0], state) == Status::BROKEN_TEXT;
+      i = 1;
+    }
+
+    const auto is_vectorizable { has_window && state.is_text_uppercase == state.is_key_uppercase &&
+                                 state.is_key_uppercase == is_key_uppercase };
+    for (; is_vectorizable && i + 16 <= size; i += 16) {
+      const auto text { _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)) };
+      const auto base { state.is_text_uppercase ? 'A' : 'a' };
+      const auto letters { SimdBytes::in_range(text, base, base + 25) };
+      const auto other_case_letters { SimdBytes::in_range(text, base ^ 32, (base ^ 32) + 25) };
+      if (_mm_movemask_epi8(_mm_or_si128(SimdBytes::broken(text), other_case_letters)) != 0) {
+        const auto status { transform_scalar(in + i, out + i, 16, state) };
+        if (status == Status::CASE_IS_DIFFERENT) {
+          return status;
+        }
+        is_broken |= status == Status::BROKEN_TEXT;
+        continue;
+      }
+
+      const auto ones { _mm_and_si128(letters, _mm_set1_epi8(1)) };
+      auto offsets { _mm_add_epi8(ones, _mm_slli_si128(ones, 1)) };
+      offsets = _mm_add_epi8(offsets, _mm_slli_si128(offsets, 2));
+      offsets = _mm_add_epi8(offsets, _mm_slli_si128(offsets, 4));
+      offsets = _mm_add_epi8(offsets, _mm_slli_si128(offsets, 8));
+      offsets = _mm_sub_epi8(offsets, ones);
+
+      const auto window { _mm_loadu_si128(reinterpret_cast<const __m128i *>(shifts.data() + state.key_position)) };
+      const auto key_shifts { _mm_shuffle_epi8(window, offsets) };
+      const auto text_offsets { _mm_sub_epi8(text, _mm_set1_epi8(base)) };
+
+      __m128i result;
+      if (is_encryption) {
+        result = _mm_add_epi8(text_offsets, key_shifts);
+        result = _mm_sub_epi8(result, _mm_and_si128(_mm_cmpgt_epi8(result, _mm_set1_epi8(25)), _mm_set1_epi8(26)));
+      } else {
+        result = _mm_sub_epi8(text_offsets, key_shifts);
+        result = _mm_add_epi8(result, _mm_and_si128(_mm_cmplt_epi8(result, _mm_setzero_si128()), _mm_set1_epi8(26)));
+      }
+      result = _mm_add_epi8(result, _mm_set1_epi8(base));
+
+      const auto blended { _mm_or_si128(_mm_and_si128(letters, result), _mm_andnot_si128(letters, text)) };
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), blended);
+
+      state.key_position = (state.key_position + std::popcount(static_cast<unsigned>(_mm_movemask_epi8(letters)))) %
+                           key.length();
+    }
+
+    const auto status { transform_scalar(in + i, out + i, size - i, state) };
+    if (status == Status::CASE_IS_DIFFERENT) {
+      return status;
+    }
+
+    return is_broken || status == Status::BROKEN_TEXT ? Status::BROKEN_TEXT : Status::OK;
+  }
+#endif
+
+ private:
+  static constexpr std::size_t max_window_key_length { 64 };
+
+  VigenereKernel(std::string_view key, bool is_encryption) noexcept : key { key }, is_encryption { is_encryption } {
+    is_key_uppercase = CharClasses::of(key[0]) == CharClasses::UPPER;
+    has_window = key.length() <= max_window_key_length && is_key_case_uniform();
+    if (has_window) {
+      const auto key_base { is_key_uppercase ? 'A' : 'a' };
+      for (std::size_t i {}; i < key.length() + 16; ++i) {
+        shifts[i] = static_cast<char>(key[i % key.length()] - key_base);
+      }
+    }
+  }
+
+  bool is_key_case_uniform() const noexcept {
+    for (auto &&ch : key) {
+      if ((CharClasses::of(ch) == CharClasses::UPPER) != is_key_uppercase) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The text case comes from the first char, the key case from the first char of the key matched to the text, which
+  // is the first char of the text itself when it is skipped.
+  Status transform_char(const char text_ch, char &out, State &state) const noexcept {
+    const auto text_class { CharClasses::of(text_ch) };
+    if (state.is_started == false) {
+      state.is_started = true;
+      state.is_text_uppercase = text_class == CharClasses::UPPER;
+      state.is_key_uppercase = text_class != CharClasses::SKIPPED && is_key_uppercase;
+    }
+
+    if (text_class == CharClasses::SKIPPED) {
+      out = text_ch;
+      return Status::OK;
+    }
+
+    const auto key_ch { key[state.key_position] };
+    state.key_position = state.key_position + 1 == key.length() ? 0 : state.key_position + 1;
+
+    if ((text_class == CharClasses::UPPER) != state.is_text_uppercase ||
+        (CharClasses::of(key_ch) == CharClasses::UPPER) != state.is_key_uppercase) {
+      return Status::CASE_IS_DIFFERENT;
+    }
+
+    if (text_class == CharClasses::BROKEN) {
+      return Status::BROKEN_TEXT;
+    }
+
+    out = is_encryption ? encrypt_char(text_ch, key_ch, state.is_text_uppercase)
+                        : decrypt_char(text_ch, key_ch, state.is_text_uppercase);
+    return Status::OK;
+  }
+
+  // Both formulas measure the key char from the base of the text case, as the old code did, so a key written in the
+  // other case than the text gives the same output as before.
+  static char encrypt_char(char text_ch, char key_ch, bool is_uppercase) noexcept {
+    const auto base { is_uppercase ? 'A' : 'a' };
+    return static_cast<char>(((text_ch - base) + (key_ch - base)) % 26 + base);
+  }
+
+  static char decrypt_char(char text_ch, char key_ch, bool is_uppercase) noexcept {
+    const auto base { is_uppercase ? 'A' : 'a' };
+    const auto decrypted { ((text_ch - base) - (key_ch - base)) % 26 + base };
+    return static_cast<char>(decrypted < base ? decrypted + 26 : decrypted);
+  }
+
+  std::string_view key;
+  bool is_encryption;
+  bool is_key_uppercase;
+  bool has_window;
+  std::array<char, max_window_key_length + 16> shifts {};
+};
+
+#endif
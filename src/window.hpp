@@ -7,10 +7,15 @@
 #include <imgui_impl_opengl3.h>
 #include <imgui_stdlib.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <memory>
 
 #include "crypto_strategies_binds.hpp"
-#include "input.hpp"
+#include "crypto_worker.hpp"
+#include "text_rows.hpp"
 
 class Alignment {
  public:
@@ -28,9 +33,17 @@ class GLFWBackendWindow {
       handle_poll();
     }
 
+    close();
     clear();
   }
 
+  // On demand the loop sleeps in glfwWaitEvents and only draws after input, a resize or a posted empty event,
+  // otherwise it redraws at the monitor refresh rate.
+  void set_on_demand_rendering(bool is_on_demand) noexcept { is_on_demand_rendering = is_on_demand; }
+
+  // Thread-safe, wakes the loop so that the next frame shows state changed outside of the GUI thread.
+  static void request_redraw() { glfwPostEmptyEvent(); }
+
  private:
   void glfw_init() {
     glfwInit();
@@ -55,12 +68,23 @@ class GLFWBackendWindow {
   }
 
   void handle_poll() {
-    glfwPollEvents();
+    wait_events();
     create_frame();
     show_main_window();
     render();
   }
 
+  // ImGui needs a couple of frames after an event to settle hover states and layout, those are drawn without waiting.
+  void wait_events() {
+    if (is_on_demand_rendering && frames_to_settle == 0) {
+      glfwWaitEvents();
+      frames_to_settle = settle_frames_count;
+    } else {
+      glfwPollEvents();
+      frames_to_settle = std::max(frames_to_settle - 1, 0);
+    }
+  }
+
   void create_frame() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -69,6 +93,9 @@ class GLFWBackendWindow {
 
   virtual void show_main_window() = 0;
 
+  // Runs after the last frame while GLFW is still initialized, e.g. to stop threads that post events.
+  virtual void close() {}
+
   std::unique_ptr<char> get_input_text() {
     constexpr auto text_size { 100 };
     auto *text { new char[text_size] {} };
@@ -103,25 +130,45 @@ class GLFWBackendWindow {
 
  protected:
   GLFWwindow *window;
+
+ private:
+  static constexpr auto settle_frames_count { 2 };
+
+  bool is_on_demand_rendering { true };
+  int frames_to_settle {};
 };
 
 class Window : public GLFWBackendWindow {
  public:
-  Window(Input &input, DataView &data_view)
-      : input { input },
+  Window(CryptoWorker &worker, DataView &data_view, const CryptoStats &stats)
+      : worker { worker },
         data_view { data_view },
+        stats { stats },
         mode { WorkMode::ENCRYPTION },
-        selected_crypto_strategy { crypto_strategies_binds[0] } {}
+        selected_crypto_strategy { crypto_strategies_binds[0] } {
+    worker.set_on_update(request_redraw);
+  }
 
  private:
-  enum class WorkMode { ENCRYPTION, DECRYPTION };
+  enum class WorkMode { ENCRYPTION, DECRYPTION, CRACK };
+
+  // The worker outlives the window, so it must not post events once glfwTerminate has run.
+  void close() override {
+    worker.stop();
+    worker.set_on_update({});
+  }
 
   void show_main_window() override {
     ImGui::SetNextWindowSize({ window_width, window_height });
     ImGui::Begin("Crypto", nullptr);
 
+    if (worker.poll()) {
+      output_rows.build(data_view.output_text, output_row_length);
+      show_cracked_key();
+    }
     show_crypto_input_table();
     show_settings_table();
+    show_file_controls();
     show_button();
 
     ImGui::End();
@@ -155,45 +202,138 @@ class Window : public GLFWBackendWindow {
     show_output_text();
   }
 
+  // Edited in place, large texts are only loaded from a file and never handed to the text widget.
   void get_text_for_encryption() {
-    ImGui::SetNextItemWidth(text_inputs_width);
-
-    std::string temp { input_text };
-    if (ImGui::InputText("###input_1", &temp)) {
-      this->input_text = temp;
+    if (input_text.size() > max_editable_size) {
+      ImGui::Text("%zu bytes", input_text.size());
+      ImGui::SameLine();
+      if (ImGui::Button("Clear")) {
+        input_text.clear();
+      }
+      return;
     }
+
+    ImGui::SetNextItemWidth(text_inputs_width);
+    ImGui::InputText("###input_1", &input_text);
   }
 
   void get_key() {
     ImGui::SetNextItemWidth(text_inputs_width);
-
-    std::string temp { key };
-    if (ImGui::InputText("###input_2", &temp)) {
-      this->key = temp;
+    ImGui::InputText("###input_2", &key);
+    if (selected_crypto_strategy == "cascade" && ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Stages run left to right, e.g. vigenere:lemon|caesar:3|aes:hellohellohelloh");
     }
   }
 
   void show_button() {
     ImGui::Spacing();
+    if (worker.get_is_running()) {
+      show_progress();
+      return;
+    }
+
     Alignment::center_by_width(button_elem_width);
     if (ImGui::Button(button_text, { button_elem_width, button_elem_height })) {
       handle_input_text();
     }
   }
 
+  void show_progress() {
+    constexpr auto megabyte { 1024.0 * 1024.0 };
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "%.1f / %.1f MB", worker.get_processed_size() / megabyte,
+                  worker.get_total_size() / megabyte);
+    Alignment::center_by_width(button_elem_width);
+    ImGui::ProgressBar(worker.get_progress(), { button_elem_width, button_elem_height }, overlay);
+
+    Alignment::center_by_width(button_elem_width);
+    if (ImGui::Button(cancel_button_text, { button_elem_width, button_elem_height })) {
+      worker.cancel();
+    }
+  }
+
+  // The worker takes a copy of the text and runs on its own thread, the result lands in the data view on a later frame.
   void handle_input_text() {
     if (mode == WorkMode::ENCRYPTION) {
-      input.encrypt(selected_crypto_strategy, input_text, key.c_str());
+      worker.encrypt(selected_crypto_strategy, input_text, key.c_str());
+    } else if (mode == WorkMode::DECRYPTION) {
+      worker.decrypt(selected_crypto_strategy, input_text, key.c_str());
     } else {
-      input.decrypt(selected_crypto_strategy, input_text, key.c_str());
+      worker.crack(selected_crypto_strategy, input_text);
+    }
+  }
+
+  // The recovered key goes into the key input, where it can be checked or used for the next operation.
+  void show_cracked_key() {
+    if (data_view.cracked_key.empty() == false) {
+      key = data_view.cracked_key;
     }
   }
 
   void show_output_text() {
+    if (data_view.output_text.size() > max_editable_size) {
+      show_large_output_text();
+      return;
+    }
+
     ImGui::SetNextItemWidth(text_inputs_width);
     ImGui::InputTextMultiline("###output", &data_view.output_text);
   }
 
+  // Read-only, only the visible rows are drawn.
+  void show_large_output_text() {
+    ImGui::BeginChild("###large_output", { text_inputs_width, large_output_height }, true,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(output_rows.size()));
+    while (clipper.Step()) {
+      for (auto i { clipper.DisplayStart }; i < clipper.DisplayEnd; ++i) {
+        const auto row { output_rows.get_row(data_view.output_text, i) };
+        ImGui::TextUnformatted(row.data(), row.data() + row.size());
+      }
+    }
+    clipper.End();
+
+    ImGui::EndChild();
+  }
+
+  void show_file_controls() {
+    ImGui::SetNextItemWidth(text_inputs_width);
+    ImGui::InputText("###file_path", &file_path);
+    ImGui::SameLine();
+    if (ImGui::Button("Load text")) {
+      load_input_text();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save output")) {
+      save_output_text();
+    }
+    ImGui::TextUnformatted(file_status.c_str());
+  }
+
+  void load_input_text() {
+    std::ifstream file { file_path, std::ios::binary };
+    if (!file) {
+      file_status = cannot_open_file_error;
+      return;
+    }
+
+    input_text.assign(std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {});
+    file_status = "Loaded " + std::to_string(input_text.size()) + " bytes.";
+  }
+
+  // The status has its own line, so a failed save never replaces the output it was meant to keep.
+  void save_output_text() {
+    std::ofstream file { file_path, std::ios::binary };
+    if (!file || !file.write(data_view.output_text.data(), data_view.output_text.size())) {
+      file_status = cannot_open_file_error;
+      return;
+    }
+
+    file_status = "Saved " + std::to_string(data_view.output_text.size()) + " bytes.";
+  }
+
   void show_settings_table() {
     if (ImGui::BeginTable("Settings", 2)) {
       ImGui::TableNextColumn();
@@ -210,6 +350,30 @@ class Window : public GLFWBackendWindow {
 
       ImGui::EndTable();
     }
+
+    if (ImGui::TreeNode("Stats")) {
+      show_stats();
+      ImGui::TreePop();
+    }
+  }
+
+  // Latencies are shown in microseconds, strategies that weren't used yet are skipped.
+  void show_stats() {
+    constexpr auto microsecond { 1000.0 };
+    for (auto &&[name, strategy_stats] : stats.get_strategies()) {
+      if (strategy_stats.calls == 0) {
+        continue;
+      }
+
+      const auto &histogram { strategy_stats.latency_histogram };
+      ImGui::Text("%.*s: %llu calls, %llu errors, %llu B in, %llu B out", static_cast<int>(name.size()), name.data(),
+                  static_cast<unsigned long long>(strategy_stats.calls.load()),
+                  static_cast<unsigned long long>(strategy_stats.errors.load()),
+                  static_cast<unsigned long long>(strategy_stats.bytes_in.load()),
+                  static_cast<unsigned long long>(strategy_stats.bytes_out.load()));
+      ImGui::Text("  p50 %.1f us, p99 %.1f us, max %.1f us", histogram.get_percentile(0.5) / microsecond,
+                  histogram.get_percentile(0.99) / microsecond, histogram.get_max() / microsecond);
+    }
   }
 
   void show_crypto_selection() {
@@ -221,6 +385,9 @@ class Window : public GLFWBackendWindow {
     } else if (ImGui::Selectable("Decrypt", selected == 1)) {
       mode = WorkMode::DECRYPTION;
       selected = 1;
+    } else if (ImGui::Selectable("Crack", selected == 2)) {
+      mode = WorkMode::CRACK;
+      selected = 2;
     }
   }
 
@@ -238,17 +405,27 @@ class Window : public GLFWBackendWindow {
   static constexpr auto text_inputs_width { 200 };
 
   static constexpr auto button_text { "Execute" };
+  static constexpr auto cancel_button_text { "Cancel" };
   static constexpr auto button_elem_width { 200 };
   static constexpr auto button_elem_height { 20 };
 
   static constexpr auto window_width { 450 };
-  static constexpr auto window_height { 300 };
+  static constexpr auto window_height { 400 };
+
+  // Larger texts go through the file controls and the row view instead of the text widgets.
+  static constexpr std::size_t max_editable_size { 1 << 16 };
+  static constexpr std::size_t output_row_length { 64 };
+  static constexpr auto large_output_height { 150 };
 
-  Input &input;
+  CryptoWorker &worker;
   DataView &data_view;
+  const CryptoStats &stats;
 
   std::string input_text;
   std::string key;
+  std::string file_path;
+  std::string file_status;
+  TextRows output_rows;
 
   WorkMode mode;
   std::string_view selected_crypto_strategy;
@@ -0,0 +1,143 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent workers with a deque of task indexes each. A worker takes tasks from the back of its own deque and, once
+// that is empty, steals from the front of the others, so uneven tasks even out without one shared queue to fight over.
+class WorkStealingPool {
+ public:
+  // Called with the task index and the index of the worker running it, e.g. to pick per-worker state.
+  using Process = std::function<void(std::size_t, unsigned)>;
+
+  explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency())
+      : queues(std::max(threads, 1u)) {
+    for (unsigned index {}; index < queues.size(); ++index) {
+      workers.emplace_back([this, index](std::stop_token stop_token) { work(stop_token, index); });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard lock { state_mutex };
+      for (auto &&worker : workers) {
+        worker.request_stop();
+      }
+    }
+    has_work.notify_all();
+  }
+
+  unsigned get_threads_count() const noexcept { return static_cast<unsigned>(queues.size()); }
+
+  // Runs process for every task in [0, tasks_count) and returns once all of them are done. The tasks are dealt out in
+  // contiguous blocks, one per worker. process must not throw. Calls from several threads are run one after another.
+  void run(std::size_t tasks_count, const Process &process) {
+    if (tasks_count == 0) {
+      return;
+    }
+
+    std::lock_guard run_lock { run_mutex };
+    const auto block_size { (tasks_count + queues.size() - 1) / queues.size() };
+    for (std::size_t index {}; index < queues.size(); ++index) {
+      std::lock_guard lock { queues[index].mutex };
+      for (auto task { index * block_size }; task < std::min(tasks_count, (index + 1) * block_size); ++task) {
+        queues[index].tasks.push_back(task);
+      }
+    }
+
+    std::unique_lock lock { state_mutex };
+    this->process = &process;
+    remaining_tasks = tasks_count;
+    ++generation;
+    has_work.notify_all();
+    is_done.wait(lock, [this] { return remaining_tasks == 0 && active_workers == 0; });
+    this->process = nullptr;
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  void work(std::stop_token stop_token, unsigned index) {
+    std::size_t seen_generation {};
+    while (true) {
+      const Process *current_process {};
+      {
+        std::unique_lock lock { state_mutex };
+        has_work.wait(lock, [&] { return stop_token.stop_requested() || generation != seen_generation; });
+        if (stop_token.stop_requested()) {
+          return;
+        }
+
+        // A late wake-up for a batch that is already done, its tasks are gone.
+        seen_generation = generation;
+        current_process = process;
+        if (current_process == nullptr) {
+          continue;
+        }
+        ++active_workers;
+      }
+
+      std::size_t done {};
+      for (std::size_t task {}; take_task(index, task);) {
+        (*current_process)(task, index);
+        ++done;
+      }
+
+      std::lock_guard lock { state_mutex };
+      remaining_tasks -= done;
+      --active_workers;
+      if (remaining_tasks == 0 && active_workers == 0) {
+        is_done.notify_all();
+      }
+    }
+  }
+
+  bool take_task(unsigned index, std::size_t &task) {
+    {
+      auto &own { queues[index] };
+      std::lock_guard lock { own.mutex };
+      if (own.tasks.empty() == false) {
+        task = own.tasks.back();
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+
+    for (std::size_t offset { 1 }; offset < queues.size(); ++offset) {
+      auto &victim { queues[(index + offset) % queues.size()] };
+      std::lock_guard lock { victim.mutex };
+      if (victim.tasks.empty() == false) {
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  std::vector<Queue> queues;
+
+  std::mutex run_mutex;
+  std::mutex state_mutex;
+  std::condition_variable has_work;
+  std::condition_variable is_done;
+  const Process *process {};
+  std::size_t remaining_tasks {};
+  std::size_t generation {};
+  unsigned active_workers {};
+
+  // Declared last, so the workers are stopped and joined before the state they use is destroyed.
+  std::vector<std::jthread> workers;
+};
+
+#endif
@@ -44,4 +44,144 @@ TEST_F(aes_decrypt_tests, decrypt_one_word) {
 TEST_F(aes_decrypt_tests, error_when_key_is_so_short) {
   ASSERT_ANY_THROW(
       crypto.decrypt("28FC955E541068C5E3F60E6505B2EF9E9E2E7847755BE5A404E3D94C05252520", "hellohellohello"));
-}
\ No newline at end of file
+}
+
+TEST_F(aes_encrypt_tests, stream_carries_partial_blocks_across_chunks) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin("hellohellohelloh");
+
+  auto actual { stream->update("hellohe") };
+  actual += stream->update("llohelloh");
+  actual += stream->finish();
+
+  ASSERT_EQ("28FC955E541068C5E3F60E6505B2EF9E9E2E7847755BE5A404E3D94C05252520", actual);
+}
+
+TEST_F(aes_decrypt_tests, stream_carries_partial_blocks_across_chunks) {
+  const auto stream { crypto.create_decryption_stream() };
+  stream->begin("hellohellohelloh");
+
+  auto actual { stream->update("28FC955E541068C5E3F60E6505B2EF9E9") };
+  actual += stream->update("E2E7847755BE5A404E3D94C05252520");
+  actual += stream->finish();
+
+  ASSERT_EQ("hellohellohelloh", actual);
+}
+
+TEST_F(aes_encrypt_tests, repeated_key_hits_cache) {
+  CryptoLibAESImplementation impl;
+
+  const auto first { impl.encrypt("Hello, World!", "hellohellohelloh") };
+  const auto second { impl.encrypt("Hello, World!", "hellohellohelloh") };
+
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(1, impl.get_encryptors().get_stats().misses);
+  ASSERT_EQ(1, impl.get_encryptors().get_stats().hits);
+}
+
+TEST_F(aes_decrypt_tests, forgotten_key_is_expanded_again) {
+  CryptoLibAESImplementation impl;
+  impl.decrypt("2194DE9B8F7D945524307B05D0561AF8", "hellohellohelloh");
+
+  impl.forget_key("hellohellohelloh");
+
+  ASSERT_EQ("Hello, World!", impl.decrypt("2194DE9B8F7D945524307B05D0561AF8", "hellohellohelloh"));
+  ASSERT_EQ(2, impl.get_decryptors().get_stats().misses);
+}
+
+TEST_F(aes_encrypt_tests, prepared_key_matches_string_key) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+
+  ASSERT_EQ("2194DE9B8F7D945524307B05D0561AF8", crypto.encrypt("Hello, World!", *key));
+  ASSERT_EQ("Hello, World!", crypto.decrypt("2194DE9B8F7D945524307B05D0561AF8", *key));
+}
+
+TEST_F(aes_encrypt_tests, encrypt_into_matches_string_result) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+  std::vector<std::byte> output(crypto.max_encrypted_size(16));
+
+  const auto size { crypto.encrypt_into(std::as_bytes(std::span { "hellohellohelloh", 16 }), output, *key) };
+
+  ASSERT_EQ("28FC955E541068C5E3F60E6505B2EF9E9E2E7847755BE5A404E3D94C05252520",
+            std::string_view(reinterpret_cast<char *>(output.data()), size));
+}
+
+TEST_F(aes_decrypt_tests, decrypt_into_strips_padding) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+  const std::string_view encrypted { "2194DE9B8F7D945524307B05D0561AF8" };
+  std::vector<std::byte> output(crypto.max_decrypted_size(encrypted.size()));
+
+  const auto size { crypto.decrypt_into(std::as_bytes(std::span { encrypted }), output, *key) };
+
+  ASSERT_EQ("Hello, World!", std::string_view(reinterpret_cast<char *>(output.data()), size));
+}
+
+TEST_F(aes_decrypt_tests, error_when_ciphertext_is_not_whole_blocks) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+  std::vector<std::byte> output(16);
+
+  ASSERT_ANY_THROW(crypto.decrypt_into(std::as_bytes(std::span { "2194DE9B", 8 }), output, *key));
+}
+
+TEST_F(aes_encrypt_tests, encrypt_in_base64) {
+  AESCryptoStrategy base64 { TextEncoding::BASE64 };
+
+  ASSERT_EQ("IZTem499lFUkMHsF0FYa+A==", base64.encrypt("Hello, World!", "hellohellohelloh"));
+  ASSERT_EQ("Hello, World!", base64.decrypt("IZTem499lFUkMHsF0FYa+A==", "hellohellohelloh"));
+}
+
+TEST_F(aes_encrypt_tests, encrypt_in_raw_bytes) {
+  AESCryptoStrategy raw { TextEncoding::RAW };
+  const std::string encrypted { "\x21\x94\xde\x9b\x8f\x7d\x94\x55\x24\x30\x7b\x05\xd0\x56\x1a\xf8" };
+
+  ASSERT_EQ(encrypted, raw.encrypt("Hello, World!", "hellohellohelloh"));
+  ASSERT_EQ("Hello, World!", raw.decrypt(encrypted, "hellohellohelloh"));
+}
+
+TEST_F(aes_encrypt_tests, max_sizes_follow_encoding) {
+  AESCryptoStrategy raw { TextEncoding::RAW };
+  AESCryptoStrategy base64 { TextEncoding::BASE64 };
+
+  ASSERT_EQ(64, crypto.max_encrypted_size(16));
+  ASSERT_EQ(32, raw.max_encrypted_size(16));
+  ASSERT_EQ(44, base64.max_encrypted_size(16));
+}
+
+TEST_F(aes_encrypt_tests, stream_in_every_encoding_matches_string_result) {
+  std::string text;
+  for (auto i { 0 }; i < 5000; ++i) {
+    text += static_cast<char>('a' + i % 26);
+  }
+
+  for (auto &&encoding : { TextEncoding::RAW, TextEncoding::HEX, TextEncoding::BASE64 }) {
+    AESCryptoStrategy strategy { encoding };
+    const auto encryption { strategy.create_encryption_stream() };
+    const auto decryption { strategy.create_decryption_stream() };
+    encryption->begin("hellohellohelloh");
+    decryption->begin("hellohellohelloh");
+
+    std::string encrypted;
+    for (std::size_t offset {}; offset < text.size(); offset += 777) {
+      encrypted += encryption->update(text.substr(offset, 777));
+    }
+    encrypted += encryption->finish();
+    std::string decrypted;
+    for (std::size_t offset {}; offset < encrypted.size(); offset += 333) {
+      decrypted += decryption->update(encrypted.substr(offset, 333));
+    }
+    decrypted += decryption->finish();
+
+    ASSERT_EQ(strategy.encrypt(text, "hellohellohelloh"), encrypted);
+    ASSERT_EQ(text, decrypted);
+  }
+}
+
+TEST_F(aes_decrypt_tests, error_when_base64_is_broken) {
+  AESCryptoStrategy base64 { TextEncoding::BASE64 };
+  const auto key { base64.prepare_key("hellohellohelloh") };
+  const std::string_view encrypted { "IZTem499lFUkMHsF0FYa+A=" };
+  std::vector<std::byte> output(base64.max_decrypted_size(encrypted.size()));
+
+  ASSERT_FALSE(base64.try_decrypt_into(std::as_bytes(std::span { encrypted }), output, *key).has_value());
+  ASSERT_ANY_THROW(base64.decrypt("IZTem499lFUkMHs.0FYa+A==", "hellohellohelloh"));
+}
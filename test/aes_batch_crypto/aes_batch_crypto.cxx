@@ -0,0 +1,146 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/aes_batch_crypto.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class aes_batch_crypto_tests : public Test {
+ public:
+  static constexpr const char *key { "hellohellohelloh" };
+
+  AESBatchCrypto crypto { TextEncoding::HEX, 4 };
+
+  // Records of every length around the block and group boundaries, more of them than fit into one task.
+  static RecordBatch make_varied_batch(std::size_t count) {
+    RecordBatch batch;
+    for (std::size_t index {}; index < count; ++index) {
+      std::string record(index % 53, '\0');
+      for (std::size_t i {}; i < record.size(); ++i) {
+        record[i] = static_cast<char>(index * 31 + i * 7);
+      }
+      batch.push_back(record);
+    }
+    return batch;
+  }
+};
+
+TEST_F(aes_batch_crypto_tests, encrypt_known_records) {
+  const auto actual { crypto.encrypt(RecordBatch { "hellohellohelloh", "Hello, World!" }, key) };
+
+  ASSERT_THAT(actual.errors, Each(IsNull()));
+  ASSERT_EQ("28FC955E541068C5E3F60E6505B2EF9E9E2E7847755BE5A404E3D94C05252520", actual.records[0]);
+  ASSERT_EQ("2194DE9B8F7D945524307B05D0561AF8", actual.records[1]);
+}
+
+TEST_F(aes_batch_crypto_tests, encrypt_in_base64) {
+  AESBatchCrypto base64 { TextEncoding::BASE64, 2 };
+
+  const auto actual { base64.encrypt(RecordBatch { "Hello, World!" }, key) };
+
+  ASSERT_EQ("IZTem499lFUkMHsF0FYa+A==", actual.records[0]);
+}
+
+TEST_F(aes_batch_crypto_tests, encrypt_with_every_key_length) {
+  const std::array<const char *, 3> keys { key, "hellohellohellohellohell", "hellohellohellohellohellohellohe" };
+
+  const auto actual { crypto.encrypt(RecordBatch { "Hello, World!", "Hello, World!", "Hello, World!" }, keys) };
+
+  ASSERT_THAT(actual.errors, Each(IsNull()));
+  ASSERT_EQ("2194DE9B8F7D945524307B05D0561AF8", actual.records[0]);
+  ASSERT_EQ("CC1625AD32CD79554B6A3F8EE70F965C", actual.records[1]);
+  ASSERT_EQ("94AB6A23C0360C4FF28B9D1804AC6DD9", actual.records[2]);
+}
+
+TEST_F(aes_batch_crypto_tests, round_trip_in_every_encoding) {
+  const auto records { make_varied_batch(1000) };
+
+  for (auto &&encoding : { TextEncoding::RAW, TextEncoding::HEX, TextEncoding::BASE64 }) {
+    AESBatchCrypto batch { encoding, 4 };
+
+    const auto encrypted { batch.encrypt(records, key) };
+    const auto decrypted { batch.decrypt(encrypted.records, key) };
+
+    ASSERT_THAT(decrypted.errors, Each(IsNull()));
+    ASSERT_EQ(records.data, decrypted.records.data);
+    ASSERT_EQ(records.offsets, decrypted.records.offsets);
+  }
+}
+
+TEST_F(aes_batch_crypto_tests, matches_aes_strategy_in_every_encoding) {
+  const auto records { make_varied_batch(300) };
+
+  for (auto &&encoding : { TextEncoding::RAW, TextEncoding::HEX, TextEncoding::BASE64 }) {
+    AESCryptoStrategy strategy { encoding };
+    AESBatchCrypto batch { encoding, 4 };
+
+    const auto actual { batch.encrypt(records, key) };
+
+    for (std::size_t index {}; index < records.size(); ++index) {
+      ASSERT_EQ(strategy.encrypt(std::string { records[index] }, key), actual.records[index]);
+    }
+  }
+}
+
+TEST_F(aes_batch_crypto_tests, round_trip_with_key_per_record) {
+  const auto records { make_varied_batch(700) };
+  const std::array<const char *, 3> distinct_keys { key, "hellohellohellohellohell",
+                                                    "hellohellohellohellohellohellohe" };
+  std::vector<const char *> keys;
+  for (std::size_t index {}; index < records.size(); ++index) {
+    keys.push_back(distinct_keys[index % 3]);
+  }
+
+  const auto encrypted { crypto.encrypt(records, keys) };
+  const auto decrypted { crypto.decrypt(encrypted.records, keys) };
+
+  ASSERT_THAT(decrypted.errors, Each(IsNull()));
+  ASSERT_EQ(records.data, decrypted.records.data);
+  ASSERT_EQ(crypto.encrypt(RecordBatch { records[3] }, key).records[0], encrypted.records[3]);
+}
+
+TEST_F(aes_batch_crypto_tests, invalid_record_key_fails_alone) {
+  const std::array<const char *, 3> keys { key, "short", key };
+
+  const auto actual { crypto.encrypt(RecordBatch { "a", "b", "c" }, keys) };
+
+  ASSERT_THAT(actual.errors, ElementsAre(IsNull(), invalid_key_length_error, IsNull()));
+  ASSERT_EQ("", actual.records[1]);
+  ASSERT_EQ(crypto.encrypt(RecordBatch { "c" }, key).records[0], actual.records[2]);
+}
+
+TEST_F(aes_batch_crypto_tests, broken_records_fail_alone) {
+  const RecordBatch records { "2194DE9B8F7D945524307B05D0561AF8", "2194DE9B", "2194DE9B8F7D945524307B05D0561AZ8",
+                              "28FC955E541068C5E3F60E6505B2EF9E", "", "Hello, World!" };
+
+  const auto actual { crypto.decrypt(records, key) };
+
+  ASSERT_THAT(actual.errors, ElementsAre(IsNull(), broken_ciphertext_error, broken_ciphertext_error,
+                                         broken_ciphertext_error, broken_ciphertext_error, broken_ciphertext_error));
+  ASSERT_EQ("Hello, World!", actual.records[0]);
+  ASSERT_EQ("", actual.records.data.substr(13));
+}
+
+TEST_F(aes_batch_crypto_tests, error_when_key_is_invalid) {
+  ASSERT_THROW(crypto.encrypt(RecordBatch { "a" }, "hellohellohello"), CryptoError);
+  ASSERT_THROW(crypto.decrypt(RecordBatch { "a" }, "hellohellohello"), CryptoError);
+}
+
+TEST_F(aes_batch_crypto_tests, error_when_keys_count_differs) {
+  const std::array<const char *, 1> keys { key };
+
+  ASSERT_THROW(crypto.encrypt(RecordBatch { "a", "b" }, keys), CryptoError);
+}
+
+TEST_F(aes_batch_crypto_tests, empty_batch) {
+  const auto actual { crypto.encrypt(RecordBatch {}, key) };
+
+  ASSERT_EQ(0, actual.records.size());
+  ASSERT_TRUE(actual.errors.empty());
+}
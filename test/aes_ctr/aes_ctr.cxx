@@ -0,0 +1,125 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/aes_ctr_crypto.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class aes_ctr_tests : public testing::Test {
+ public:
+  AESCTRCryptoStrategy crypto { 4 };
+
+  static std::string make_text(std::size_t size) {
+    std::string text(size, '\0');
+    for (std::size_t i {}; i < size; ++i) {
+      text[i] = static_cast<char>(i * 7 + i / 251);
+    }
+    return text;
+  }
+};
+
+class aes_ctr_encrypt_tests : public aes_ctr_tests {};
+
+class aes_ctr_decrypt_tests : public aes_ctr_tests {};
+
+// NIST SP 800-38A, F.5.1 CTR-AES128.Encrypt, first block.
+TEST_F(aes_ctr_encrypt_tests, encrypt_nist_vector) {
+  const AESCounterMode::Nonce nonce { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                      0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+
+  const AESCounterKey key { "\x2b\x7e\x15\x16\x28\xae\xd2\xa6\xab\xf7\x15\x88\x09\xcf\x4f\x3c" };
+
+  const auto actual { crypto.encrypt_with_nonce(
+      "\x6b\xc1\xbe\xe2\x2e\x40\x9f\x96\xe9\x3d\x7e\x11\x73\x93\x17\x2a", key, nonce) };
+
+  ASSERT_EQ("F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF874D6191B620E3261BEF6864990DB6CE", actual);
+}
+
+TEST_F(aes_ctr_encrypt_tests, encrypt_and_decrypt_short_text) {
+  const auto encrypted { crypto.encrypt("Hello, World!", "hellohellohelloh") };
+
+  ASSERT_EQ(2 * (16 + 13), encrypted.size());
+  ASSERT_EQ("Hello, World!", crypto.decrypt(encrypted, "hellohellohelloh"));
+}
+
+TEST_F(aes_ctr_encrypt_tests, nonce_is_random) {
+  ASSERT_NE(crypto.encrypt("hello", "hellohellohelloh"), crypto.encrypt("hello", "hellohellohelloh"));
+}
+
+TEST_F(aes_ctr_encrypt_tests, parallel_ranges_match_single_thread) {
+  AESCTRCryptoStrategy single_thread { 1 };
+  const auto text { make_text((1 << 21) + 5) };
+  const AESCounterMode::Nonce nonce { 1, 2, 3 };
+  const AESCounterKey key { "hellohellohellohellohell" };
+
+  ASSERT_EQ(single_thread.encrypt_with_nonce(text, key, nonce), crypto.encrypt_with_nonce(text, key, nonce));
+}
+
+TEST_F(aes_ctr_encrypt_tests, error_in_parallel_range_reaches_caller) {
+  const auto process { [](std::size_t begin, std::size_t) {
+    if (begin != 0) {
+      throw_exception(operation_failed_error);
+    }
+  } };
+
+  ASSERT_THROW(ParallelRanges::run(4 << 20, 4, AESCounterMode::block_size, 1 << 20, process), CryptoError);
+}
+
+TEST_F(aes_ctr_encrypt_tests, error_when_key_is_so_short) {
+  ASSERT_ANY_THROW(crypto.encrypt("hellohellohelloh", "hellohellohellh"));
+}
+
+TEST_F(aes_ctr_decrypt_tests, decrypt_large_text_in_parallel) {
+  const auto text { make_text(3 << 20) };
+
+  ASSERT_EQ(text, crypto.decrypt(crypto.encrypt(text, "hellohellohellohellohellohelloh!"),
+                                 "hellohellohellohellohellohelloh!"));
+}
+
+TEST_F(aes_ctr_decrypt_tests, error_when_ciphertext_is_shorter_than_nonce) {
+  ASSERT_ANY_THROW(crypto.decrypt("F0F1F2F3", "hellohellohelloh"));
+}
+
+TEST_F(aes_ctr_decrypt_tests, error_when_ciphertext_is_not_hex) {
+  ASSERT_ANY_THROW(
+      crypto.decrypt("F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF874D6191B620E3261BEF6864990DB6ZZ", "hellohellohelloh"));
+}
+
+TEST_F(aes_ctr_decrypt_tests, stream_decrypts_chunks) {
+  const auto encrypted { crypto.encrypt("Hello, World!", "hellohellohelloh") };
+  const auto stream { crypto.create_decryption_stream() };
+  stream->begin("hellohellohelloh");
+
+  auto actual { stream->update(encrypted.substr(0, 11)) };
+  actual += stream->update(encrypted.substr(11));
+  actual += stream->finish();
+
+  ASSERT_EQ("Hello, World!", actual);
+}
+
+TEST_F(aes_ctr_decrypt_tests, prepared_key_decrypts_many_texts) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+
+  for (const auto *text : { "a", "Hello, World!", "hellohellohellohello" }) {
+    ASSERT_EQ(text, crypto.decrypt(crypto.encrypt(text, *key), *key));
+  }
+}
+
+TEST_F(aes_ctr_encrypt_tests, encrypt_into_reuses_output_buffer) {
+  const auto key { crypto.prepare_key("hellohellohelloh") };
+  std::vector<std::byte> encrypted(crypto.max_encrypted_size(13));
+  std::vector<std::byte> decrypted(crypto.max_decrypted_size(encrypted.size()));
+
+  const auto text { std::as_bytes(std::span { "Hello, World!", 13 }) };
+
+  for (auto i { 0 }; i < 3; ++i) {
+    const auto encrypted_size { crypto.encrypt_into(text, encrypted, *key) };
+    const auto size { crypto.decrypt_into({ encrypted.data(), encrypted_size }, decrypted, *key) };
+
+    ASSERT_EQ("Hello, World!", std::string_view(reinterpret_cast<char *>(decrypted.data()), size));
+  }
+}
@@ -0,0 +1,116 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "src/batch_crypto.hpp"
+#include "src/caesar_crypto.hpp"
+#include "src/vigenere_crypto.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class batch_crypto_tests : public Test {
+ public:
+  CaesarCryptoStrategy caesar;
+  VigenereCryptoStrategy vigenere;
+};
+
+TEST_F(batch_crypto_tests, record_batch_layout) {
+  const RecordBatch actual { "ab", "", "cde" };
+
+  ASSERT_EQ(3, actual.size());
+  ASSERT_EQ("abcde", actual.data);
+  ASSERT_THAT(actual.offsets, ElementsAre(0, 2, 2, 5));
+  ASSERT_EQ("cde", actual[2]);
+}
+
+TEST_F(batch_crypto_tests, pool_runs_every_task_once) {
+  WorkStealingPool pool { 4 };
+  std::vector<std::atomic<int>> runs(1000);
+
+  pool.run(runs.size(), [&runs](std::size_t task, unsigned) { ++runs[task]; });
+
+  ASSERT_TRUE(std::ranges::all_of(runs, [](auto &&count) { return count == 1; }));
+}
+
+TEST_F(batch_crypto_tests, pool_can_be_reused) {
+  WorkStealingPool pool { 3 };
+  std::atomic<std::size_t> sum {};
+
+  for (auto i { 0 }; i < 100; ++i) {
+    pool.run(10, [&sum](std::size_t task, unsigned) { sum += task; });
+  }
+
+  ASSERT_EQ(100 * 45, sum);
+}
+
+TEST_F(batch_crypto_tests, idle_workers_steal_tasks) {
+  WorkStealingPool pool { 2 };
+  std::atomic<bool> is_released {};
+  std::atomic<int> started {};
+  std::atomic<int> done {};
+  std::vector<unsigned> workers(4);
+
+  // The first task blocks its worker until the other one has run the remaining three, one of which it has to steal.
+  pool.run(workers.size(), [&](std::size_t task, unsigned worker) {
+    workers[task] = worker;
+    if (started++ == 0) {
+      is_released.wait(false);
+    } else if (++done == 3) {
+      is_released = true;
+      is_released.notify_all();
+    }
+  });
+
+  const std::vector tasks_per_worker { std::ranges::count(workers, 0u), std::ranges::count(workers, 1u) };
+  ASSERT_THAT(tasks_per_worker, UnorderedElementsAre(1, 3));
+}
+
+TEST_F(batch_crypto_tests, encrypt_records) {
+  BatchCrypto batch { caesar, 2 };
+
+  const auto actual { batch.encrypt(RecordBatch { "abc", "Hello, World", "" }, "1") };
+
+  ASSERT_EQ(3, actual.records.size());
+  ASSERT_EQ("bcd", actual.records[0]);
+  ASSERT_EQ("Ifmmp, Xpsme", actual.records[1]);
+  ASSERT_EQ("", actual.records[2]);
+  ASSERT_THAT(actual.errors, Each(IsNull()));
+}
+
+TEST_F(batch_crypto_tests, failed_record_gets_its_error) {
+  BatchCrypto batch { vigenere, 2 };
+
+  const auto actual { batch.encrypt(RecordBatch { "hello", "hi", "world" }, "key") };
+
+  ASSERT_EQ("rijvs", actual.records[0]);
+  ASSERT_EQ("", actual.records[1]);
+  ASSERT_EQ("gspvh", actual.records[2]);
+  ASSERT_THAT(actual.errors, ElementsAre(IsNull(), key_longer_than_text_error, IsNull()));
+}
+
+TEST_F(batch_crypto_tests, error_when_key_is_invalid) {
+  BatchCrypto batch { vigenere, 2 };
+
+  ASSERT_THROW(batch.encrypt(RecordBatch { "hello" }, "k3y"), CryptoError);
+}
+
+TEST_F(batch_crypto_tests, many_records_round_trip) {
+  RecordBatch records;
+  for (auto i { 0 }; i < 10'000; ++i) {
+    records.push_back(std::string(100 + i % 400, static_cast<char>('a' + i % 26)));
+  }
+  BatchCrypto batch { vigenere, 4 };
+
+  const auto encrypted { batch.encrypt(records, "lemon") };
+  const auto actual { batch.decrypt(encrypted.records, "lemon") };
+
+  ASSERT_EQ(records.data, actual.records.data);
+  ASSERT_EQ(records.offsets, actual.records.offsets);
+}
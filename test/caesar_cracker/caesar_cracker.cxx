@@ -0,0 +1,121 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "src/crackers.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class caesar_cracker_tests : public Test {
+ public:
+  static constexpr std::string_view plain_text {
+    "It was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness, "
+    "it was the epoch of belief, it was the epoch of incredulity, it was the season of Light, it was the season of "
+    "Darkness, it was the spring of hope, it was the winter of despair."
+  };
+
+  const std::filesystem::path directory { std::filesystem::temp_directory_path() / "caesar_cracker_tests" };
+  const std::string input_path { directory / "input.txt" };
+  const std::string output_path { directory / "output.txt" };
+
+  CaesarCryptoStrategy strategy;
+
+  void SetUp() override { std::filesystem::create_directories(directory); }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  std::string encrypt(std::string_view text, int shift) { return strategy.encrypt(std::string { text }, shift); }
+
+  static std::string read_file(const std::string &path) {
+    std::ifstream file { path, std::ios::binary };
+    return { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+  }
+};
+
+TEST_F(caesar_cracker_tests, recover_every_shift) {
+  for (auto shift { 0 }; shift < 26; ++shift) {
+    const auto actual { CaesarCracker::crack(encrypt(plain_text, shift)) };
+
+    ASSERT_EQ(std::to_string(shift), actual.key);
+    ASSERT_EQ(plain_text, actual.plain_text);
+  }
+}
+
+TEST_F(caesar_cracker_tests, ranking_is_sorted_and_has_every_shift) {
+  const auto ranking { CaesarCracker::rank(encrypt(plain_text, 7)) };
+
+  ASSERT_EQ(7, ranking[0].shift);
+  ASSERT_TRUE(std::ranges::is_sorted(ranking, {}, &CaesarCracker::Candidate::chi_squared));
+  std::array<bool, 26> is_seen {};
+  for (auto &&candidate : ranking) {
+    is_seen[candidate.shift] = true;
+  }
+  ASSERT_THAT(is_seen, Each(true));
+}
+
+TEST_F(caesar_cracker_tests, chunks_count_like_whole_text) {
+  const auto text { encrypt(plain_text, 3) };
+  CaesarCracker cracker;
+  for (std::size_t offset {}; offset < text.size(); offset += 10) {
+    cracker.update(std::string_view { text }.substr(offset, 10));
+  }
+
+  ASSERT_EQ(LetterHistogram::count(text), cracker.get_counts());
+}
+
+TEST_F(caesar_cracker_tests, parallel_update_counts_like_one_thread) {
+  std::string text;
+  while (text.size() < 2 * CaesarCracker::parallel_chunk_size) {
+    text += plain_text;
+  }
+  CaesarCracker parallel { 4 };
+  CaesarCracker single { 1 };
+
+  parallel.update(text);
+  single.update(text);
+
+  ASSERT_EQ(single.get_counts(), parallel.get_counts());
+}
+
+TEST_F(caesar_cracker_tests, error_when_text_has_no_letters) {
+  try {
+    CaesarCracker::rank(", . !");
+    FAIL();
+  } catch (const CryptoError &e) {
+    ASSERT_EQ(not_enough_letters_error, e.get_error());
+  }
+}
+
+TEST_F(caesar_cracker_tests, crack_by_strategy_name) {
+  const auto actual { Crackers::crack("caesar", encrypt(plain_text, 11)) };
+
+  ASSERT_EQ("11", actual.key);
+  ASSERT_EQ(plain_text, actual.plain_text);
+}
+
+TEST_F(caesar_cracker_tests, crack_file_into_other_file) {
+  std::ofstream { input_path, std::ios::binary } << encrypt(plain_text, 19);
+
+  const auto actual { Crackers::crack_file("caesar", input_path, output_path) };
+
+  ASSERT_EQ("19", actual.key);
+  ASSERT_EQ(plain_text.size(), actual.report.bytes_out);
+  ASSERT_EQ(plain_text, read_file(output_path));
+}
+
+TEST_F(caesar_cracker_tests, crack_file_in_place) {
+  std::ofstream { input_path, std::ios::binary } << encrypt(plain_text, 5);
+
+  Crackers::crack_file("caesar", input_path, input_path);
+
+  ASSERT_EQ(plain_text, read_file(input_path));
+}
@@ -0,0 +1,138 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/caesar_crypto.hpp"
+#include "src/cascade_crypto.hpp"
+#include "src/vigenere_crypto.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class cascade_tests : public Test {
+ public:
+  static constexpr auto key { "vigenere:lemon|caesar:3" };
+
+  CaesarCryptoStrategy caesar;
+  VigenereCryptoStrategy vigenere;
+  std::unique_ptr<CascadeCryptoStrategy> cascade;
+
+  void SetUp() {
+    CascadeStages stages;
+    stages["caesar"].reset(new CaesarCryptoStrategy);
+    stages["vigenere"].reset(new VigenereCryptoStrategy);
+    cascade.reset(new CascadeCryptoStrategy { std::move(stages) });
+  }
+
+  // What the cascade replaces: one full pass and one string per stage.
+  std::string encrypt_stage_by_stage(const std::string &text) {
+    return caesar.encrypt(vigenere.encrypt(text, std::any { "lemon" }), std::any { 3 });
+  }
+
+  static std::string make_text(std::size_t size) {
+    std::string text;
+    for (std::size_t i {}; i < size; ++i) {
+      text += i % 7 == 6 ? ' ' : static_cast<char>('a' + i * 5 % 26);
+    }
+    return text;
+  }
+
+  static void assert_error(ErrorCode error, std::function<void()> process) {
+    try {
+      process();
+      FAIL();
+    } catch (const CryptoError &e) {
+      ASSERT_EQ(error, e.get_error());
+    }
+  }
+};
+
+TEST_F(cascade_tests, encrypt_like_stages_in_order) {
+  const std::string text { "hello, world" };
+
+  ASSERT_EQ(encrypt_stage_by_stage(text), cascade->encrypt(text, std::any { key }));
+}
+
+TEST_F(cascade_tests, decrypt_in_reverse_order) {
+  const std::string text { "hello, world" };
+
+  ASSERT_EQ(text, cascade->decrypt(cascade->encrypt(text, std::any { key }), std::any { key }));
+}
+
+TEST_F(cascade_tests, state_is_carried_across_blocks) {
+  const auto text { make_text(3 * CascadeCryptoStrategy::block_size + 5) };
+
+  ASSERT_EQ(encrypt_stage_by_stage(text), cascade->encrypt(text, std::any { key }));
+}
+
+TEST_F(cascade_tests, encrypt_into_with_prepared_key) {
+  const auto text { make_text(100) };
+  const auto prepared_key { cascade->prepare_key(key) };
+  std::string output(cascade->max_encrypted_size(text.size()), '\0');
+
+  const auto size { cascade->encrypt_into(std::as_bytes(std::span { text }),
+                                          std::as_writable_bytes(std::span { output }), *prepared_key) };
+
+  output.resize(size);
+  ASSERT_EQ(encrypt_stage_by_stage(text), output);
+}
+
+TEST_F(cascade_tests, stream_in_chunks) {
+  const auto text { make_text(1000) };
+  const auto stream { cascade->create_decryption_stream() };
+  const auto encrypted { encrypt_stage_by_stage(text) };
+
+  stream->begin(std::any { key });
+  std::string actual;
+  for (std::size_t offset {}; offset < encrypted.size(); offset += 99) {
+    actual += stream->update(encrypted.substr(offset, 99));
+  }
+  actual += stream->finish();
+
+  ASSERT_EQ(text, actual);
+}
+
+TEST_F(cascade_tests, one_stage_is_the_strategy_itself) {
+  const std::string text { "hello, world" };
+
+  ASSERT_EQ(caesar.encrypt(text, std::any { 5 }), cascade->encrypt(text, std::any { "caesar:5" }));
+}
+
+TEST_F(cascade_tests, error_of_stage_is_passed_on) {
+  assert_error(broken_text_error, [&] { cascade->encrypt("hello 1", std::any { key }); });
+}
+
+TEST_F(cascade_tests, error_when_stage_is_unknown) {
+  assert_error(unknown_crypto_strategy_error, [&] { cascade->prepare_key("rot13:1"); });
+}
+
+TEST_F(cascade_tests, error_when_stage_has_no_key) {
+  assert_error(cascade_key_error, [&] { cascade->prepare_key("vigenere:lemon|caesar"); });
+  assert_error(cascade_key_error, [&] { cascade->prepare_key(""); });
+}
+
+TEST_F(cascade_tests, error_when_stages_are_too_many) {
+  assert_error(cascade_key_error, [&] { cascade->prepare_key("caesar:1|caesar:2|caesar:3|caesar:4|caesar:5"); });
+}
+
+TEST_F(cascade_tests, error_when_numeric_key_is_wrong) { ASSERT_ANY_THROW(cascade->prepare_key("caesar:x")); }
+
+TEST_F(cascade_tests, max_sizes_cover_length_preserving_stages) {
+  ASSERT_LE(100, cascade->max_encrypted_size(100));
+  ASSERT_LE(100, cascade->max_decrypted_size(100));
+}
+
+TEST_F(cascade_tests, max_sizes_follow_stages_of_key) {
+  const auto text { make_text(100) };
+  const auto prepared_key { cascade->prepare_key(key) };
+  std::string output(cascade->max_encrypted_size(text.size(), *prepared_key), '\0');
+
+  ASSERT_EQ(text.size(), output.size());
+  ASSERT_EQ(text.size(), cascade->max_decrypted_size(text.size(), *prepared_key));
+  ASSERT_EQ(text.size(), cascade->encrypt_into(std::as_bytes(std::span { text }),
+                                               std::as_writable_bytes(std::span { output }), *prepared_key));
+}
@@ -0,0 +1,114 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/command_line.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class command_line_tests : public testing::Test {
+ public:
+  static CommandLine parse(std::initializer_list<const char *> args) {
+    return CommandLine { { args.begin(), args.size() } };
+  }
+};
+
+TEST_F(command_line_tests, parse_strategy_mode_and_key) {
+  const auto actual { parse({ "vigenere", "decrypt", "BYE" }) };
+
+  ASSERT_EQ("vigenere", actual.crypto_strategy_name);
+  ASSERT_EQ(CommandLine::Mode::DECRYPTION, actual.mode);
+  ASSERT_STREQ("BYE", actual.key);
+}
+
+TEST_F(command_line_tests, standard_streams_by_default) {
+  const auto actual { parse({ "caesar", "encrypt", "1" }) };
+
+  ASSERT_TRUE(CommandLine::is_standard_stream(actual.input_path));
+  ASSERT_TRUE(CommandLine::is_standard_stream(actual.output_path));
+}
+
+TEST_F(command_line_tests, parse_input_and_output_paths) {
+  const auto actual { parse({ "aes", "encrypt", "hellohellohelloh", "in.txt", "out.txt" }) };
+
+  ASSERT_EQ("in.txt", actual.input_path);
+  ASSERT_EQ("out.txt", actual.output_path);
+}
+
+TEST_F(command_line_tests, error_when_strategy_is_unknown) { ASSERT_ANY_THROW(parse({ "rot13", "encrypt", "1" })); }
+
+TEST_F(command_line_tests, error_when_mode_is_unknown) { ASSERT_ANY_THROW(parse({ "caesar", "scramble", "1" })); }
+
+TEST_F(command_line_tests, error_when_arguments_count_is_wrong) { ASSERT_ANY_THROW(parse({ "caesar", "encrypt" })); }
+
+TEST_F(command_line_tests, parse_crack_without_key) {
+  const auto actual { parse({ "vigenere", "crack", "in.txt" }) };
+
+  ASSERT_EQ(CommandLine::Mode::CRACK, actual.mode);
+  ASSERT_EQ(nullptr, actual.key);
+  ASSERT_EQ("in.txt", actual.input_path);
+  ASSERT_TRUE(CommandLine::is_standard_stream(actual.output_path));
+}
+
+TEST_F(command_line_tests, error_when_crack_has_too_many_arguments) {
+  ASSERT_ANY_THROW(parse({ "vigenere", "crack", "key", "in.txt", "out.txt" }));
+}
+
+TEST_F(command_line_tests, parse_file_mode) {
+  const auto actual { parse({ "--mmap", "caesar", "encrypt", "3", "in.txt", "out.txt" }) };
+
+  ASSERT_TRUE(actual.is_file_mode);
+  ASSERT_EQ("caesar", actual.crypto_strategy_name);
+  ASSERT_EQ("out.txt", actual.output_path);
+}
+
+TEST_F(command_line_tests, error_when_file_mode_has_no_paths) {
+  ASSERT_ANY_THROW(parse({ "--mmap", "caesar", "encrypt", "3" }));
+}
+
+TEST_F(command_line_tests, parse_stats_flag) {
+  const auto actual { parse({ "--stats", "caesar", "encrypt", "3" }) };
+
+  ASSERT_TRUE(actual.is_stats_enabled);
+  ASSERT_FALSE(actual.is_file_mode);
+  ASSERT_EQ("caesar", actual.crypto_strategy_name);
+}
+
+TEST_F(command_line_tests, parse_stats_flag_with_file_mode) {
+  const auto actual { parse({ "--stats", "--mmap", "caesar", "encrypt", "3", "in.txt", "out.txt" }) };
+
+  ASSERT_TRUE(actual.is_stats_enabled);
+  ASSERT_TRUE(actual.is_file_mode);
+}
+
+TEST_F(command_line_tests, stats_are_disabled_by_default) {
+  ASSERT_FALSE(parse({ "caesar", "encrypt", "3" }).is_stats_enabled);
+}
+
+TEST_F(command_line_tests, error_when_flag_is_unknown) {
+  ASSERT_ANY_THROW(parse({ "--fast", "caesar", "encrypt", "3" }));
+}
+
+TEST_F(command_line_tests, parse_trace_flag) {
+  const auto actual { parse({ "--trace=trace.json", "aes", "encrypt", "hellohellohelloh" }) };
+
+  ASSERT_EQ("trace.json", actual.trace_path);
+  ASSERT_EQ("aes", actual.crypto_strategy_name);
+}
+
+TEST_F(command_line_tests, error_when_trace_has_no_path) {
+  ASSERT_ANY_THROW(parse({ "--trace=", "caesar", "encrypt", "3" }));
+}
+
+TEST_F(command_line_tests, parse_encoding_flag) {
+  ASSERT_EQ(TextEncoding::HEX, parse({ "aes", "encrypt", "hellohellohelloh" }).encoding);
+  ASSERT_EQ(TextEncoding::BASE64, parse({ "--encoding=base64", "aes", "encrypt", "hellohellohelloh" }).encoding);
+  ASSERT_EQ(TextEncoding::RAW, parse({ "--encoding=raw", "--mmap", "aes", "encrypt", "k", "in", "out" }).encoding);
+}
+
+TEST_F(command_line_tests, error_when_encoding_is_unknown) {
+  ASSERT_ANY_THROW(parse({ "--encoding=base32", "aes", "encrypt", "hellohellohelloh" }));
+}
@@ -0,0 +1,133 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "src/crypto_strategies_factory.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class concurrency_tests : public Test {
+ public:
+  static constexpr auto threads_count { 8 };
+  static constexpr auto iterations_count { 200 };
+
+  static constexpr std::array<const char *, 5> keys { "3", "lemon", "hellohellohelloh", "hellohellohelloh",
+                                                      "vigenere:lemon|caesar:3|aes:hellohellohelloh" };
+
+  SharedCryptoStrategies crypto_strategies { make_shared_crypto_strategies() };
+
+  static std::string make_text(int seed) {
+    std::string text;
+    for (auto i { 0 }; i < 40 + seed % 50; ++i) {
+      text += static_cast<char>('a' + (seed + i) % 26);
+    }
+    return text;
+  }
+
+  // Runs body(thread, iteration) on every thread at once.
+  template <class Body>
+  static void run_concurrently(Body body) {
+    std::vector<std::jthread> threads;
+    for (auto thread { 0 }; thread < threads_count; ++thread) {
+      threads.emplace_back([&body, thread] {
+        for (auto iteration { 0 }; iteration < iterations_count; ++iteration) {
+          body(thread, iteration);
+        }
+      });
+    }
+  }
+};
+
+TEST_F(concurrency_tests, inputs_share_one_registry) {
+  std::atomic<int> failures {};
+
+  run_concurrently([&](int thread, int iteration) {
+    DataView data_view;
+    CryptoInput input { data_view, crypto_strategies };
+    const auto index { static_cast<std::size_t>(thread + iteration) % crypto_strategies_binds.size() };
+    const auto text { make_text(thread * iterations_count + iteration) };
+
+    input.encrypt(crypto_strategies_binds[index], text, keys[index]);
+    const auto encrypted { data_view.output_text };
+    input.decrypt(crypto_strategies_binds[index], encrypted, keys[index]);
+
+    failures += data_view.has_error || data_view.output_text != text;
+  });
+
+  ASSERT_EQ(0, failures);
+}
+
+TEST_F(concurrency_tests, results_match_single_threaded_ones) {
+  DataView data_view;
+  CryptoInput input { data_view, crypto_strategies };
+  std::vector<std::string> expected;
+  for (auto thread { 0 }; thread < threads_count; ++thread) {
+    input.encrypt("aes", make_text(thread), keys[2]);
+    expected.push_back(data_view.output_text);
+  }
+  std::atomic<int> failures {};
+
+  run_concurrently([&](int thread, int) {
+    DataView data_view;
+    CryptoInput input { data_view, crypto_strategies };
+    input.encrypt("aes", make_text(thread), keys[2]);
+
+    failures += data_view.output_text != expected[thread];
+  });
+
+  ASSERT_EQ(0, failures);
+}
+
+TEST_F(concurrency_tests, aes_key_cache_is_shared_under_evictions) {
+  CryptoLibAESImplementation impl { 2 };
+  const std::array<std::string, 4> aes_keys { "hellohellohelloh", "worldworldworldw", "0123456789abcdef",
+                                              "fedcba9876543210" };
+  std::atomic<int> failures {};
+
+  run_concurrently([&](int thread, int iteration) {
+    const auto &key { aes_keys[(thread + iteration) % aes_keys.size()] };
+    const auto text { make_text(iteration) };
+    if (iteration % 50 == 0) {
+      impl.forget_key(key);
+    }
+
+    failures += impl.decrypt(impl.encrypt(text, key), key) != text;
+  });
+
+  ASSERT_EQ(0, failures);
+}
+
+TEST_F(concurrency_tests, prepared_key_per_thread) {
+  std::atomic<int> failures {};
+
+  run_concurrently([&](int thread, int iteration) {
+    const auto index { static_cast<std::size_t>(thread) % crypto_strategies_binds.size() };
+    auto &strategy { *crypto_strategies->at(crypto_strategies_binds[index]) };
+    const auto key { strategy.prepare_key(keys[index]) };
+    const auto text { make_text(iteration) };
+
+    failures += strategy.decrypt(strategy.encrypt(text, *key), *key) != text;
+  });
+
+  ASSERT_EQ(0, failures);
+}
+
+TEST_F(concurrency_tests, stats_are_shared) {
+  CryptoStats stats { crypto_strategies_binds };
+
+  run_concurrently([&](int, int iteration) {
+    DataView data_view;
+    CryptoInput input { data_view, crypto_strategies };
+    input.set_stats(&stats);
+    input.encrypt("caesar", make_text(iteration), keys[0]);
+  });
+
+  ASSERT_EQ(threads_count * iterations_count, stats.get_strategies().at("caesar").calls);
+}
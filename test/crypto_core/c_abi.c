@@ -0,0 +1,27 @@
+#include "src/crypto_core.h"
+
+#include <string.h>
+
+// Built as C, so the header is checked to be valid C. Encrypts and decrypts text into decrypted, the first error stops.
+const char *round_trip_from_c(const char *strategy, const char *key, const char *text, char *decrypted,
+                              size_t decrypted_capacity, size_t *decrypted_size) {
+  crypto_context *context = NULL;
+  crypto_key *prepared_key = NULL;
+  const char *error = crypto_context_create(NULL, &context);
+  if (error == NULL) {
+    error = crypto_prepare_key(context, strategy, key, &prepared_key);
+  }
+
+  char encrypted[256];
+  size_t encrypted_size = 0;
+  if (error == NULL) {
+    error = crypto_encrypt_into(prepared_key, text, strlen(text), encrypted, sizeof(encrypted), &encrypted_size);
+  }
+  if (error == NULL) {
+    error = crypto_decrypt_into(prepared_key, encrypted, encrypted_size, decrypted, decrypted_capacity, decrypted_size);
+  }
+
+  crypto_key_free(prepared_key);
+  crypto_context_free(context);
+  return error;
+}
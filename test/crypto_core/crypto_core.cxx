@@ -0,0 +1,118 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/crypto_core.h"
+#include "src/errors.hpp"
+
+extern "C" const char *round_trip_from_c(const char *strategy, const char *key, const char *text, char *decrypted,
+                                         size_t decrypted_capacity, size_t *decrypted_size);
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class crypto_core_tests : public Test {
+ public:
+  crypto_context *context {};
+
+  void SetUp() { ASSERT_EQ(nullptr, crypto_context_create(nullptr, &context)); }
+
+  void TearDown() { crypto_context_free(context); }
+
+  std::string encrypt(crypto_key *key, const std::string &text) {
+    std::string out(crypto_max_encrypted_size(key, text.size()), '\0');
+    std::size_t size {};
+    EXPECT_EQ(nullptr, crypto_encrypt_into(key, text.data(), text.size(), out.data(), out.size(), &size));
+    out.resize(size);
+    return out;
+  }
+};
+
+TEST_F(crypto_core_tests, abi_version_matches_header) { ASSERT_EQ(CRYPTO_CORE_ABI_VERSION, crypto_core_abi_version()); }
+
+TEST_F(crypto_core_tests, caesar_encrypt_into) {
+  crypto_key *key {};
+  ASSERT_EQ(nullptr, crypto_prepare_key(context, "caesar", "1", &key));
+
+  ASSERT_EQ("IfMmP, XpSmE", encrypt(key, "HeLlO, WoRlD"));
+
+  crypto_key_free(key);
+}
+
+TEST_F(crypto_core_tests, aes_decrypt_into) {
+  crypto_key *key {};
+  ASSERT_EQ(nullptr, crypto_prepare_key(context, "aes", "hellohellohelloh", &key));
+  const std::string ciphertext { "2194DE9B8F7D945524307B05D0561AF8" };
+  std::string out(crypto_max_decrypted_size(key, ciphertext.size()), '\0');
+  std::size_t size {};
+
+  ASSERT_EQ(nullptr, crypto_decrypt_into(key, ciphertext.data(), ciphertext.size(), out.data(), out.size(), &size));
+  out.resize(size);
+
+  ASSERT_EQ("Hello, World!", out);
+  crypto_key_free(key);
+}
+
+TEST_F(crypto_core_tests, round_trip_from_c) {
+  char decrypted[64] {};
+  std::size_t size {};
+
+  ASSERT_EQ(nullptr, round_trip_from_c("vigenere", "LEMON", "ATTACK AT DAWN", decrypted, sizeof(decrypted), &size));
+
+  ASSERT_EQ("ATTACK AT DAWN", std::string(decrypted, size));
+}
+
+TEST_F(crypto_core_tests, raw_encoding) {
+  crypto_context *raw {};
+  ASSERT_EQ(nullptr, crypto_context_create("raw", &raw));
+  crypto_key *key {};
+  ASSERT_EQ(nullptr, crypto_prepare_key(raw, "aes", "hellohellohelloh", &key));
+
+  ASSERT_EQ(16, encrypt(key, "Hello, World!").size());
+
+  crypto_key_free(key);
+  crypto_context_free(raw);
+}
+
+TEST_F(crypto_core_tests, error_when_output_buffer_is_too_small) {
+  crypto_key *key {};
+  ASSERT_EQ(nullptr, crypto_prepare_key(context, "caesar", "1", &key));
+  char out[4];
+  std::size_t size {};
+
+  ASSERT_STREQ(output_buffer_is_too_small_error, crypto_encrypt_into(key, "hello", 5, out, sizeof(out), &size));
+
+  crypto_key_free(key);
+}
+
+TEST_F(crypto_core_tests, error_when_text_is_broken) {
+  crypto_key *key {};
+  ASSERT_EQ(nullptr, crypto_prepare_key(context, "aes", "hellohellohelloh", &key));
+  char out[64];
+  std::size_t size {};
+
+  ASSERT_STREQ(broken_ciphertext_error, crypto_decrypt_into(key, "2194", 4, out, sizeof(out), &size));
+
+  crypto_key_free(key);
+}
+
+TEST_F(crypto_core_tests, error_when_key_or_strategy_is_invalid) {
+  crypto_key *key {};
+
+  ASSERT_STREQ(key_contains_non_alphabetic_chars_error, crypto_prepare_key(context, "vigenere", "l3mon", &key));
+  ASSERT_STREQ(invalid_key_error, crypto_prepare_key(context, "caesar", "three", &key));
+  ASSERT_STREQ(unknown_crypto_strategy_error, crypto_prepare_key(context, "rot13", "1", &key));
+  ASSERT_EQ(nullptr, key);
+}
+
+TEST_F(crypto_core_tests, error_when_encoding_is_unknown) {
+  crypto_context *other {};
+
+  ASSERT_STREQ(unknown_encoding_error, crypto_context_create("base32", &other));
+}
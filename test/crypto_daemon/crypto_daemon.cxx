@@ -0,0 +1,248 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "src/crypto_daemon.hpp"
+#include "src/daemon_client.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class crypto_daemon_tests : public Test {
+ public:
+  const std::string socket_path {
+    (std::filesystem::temp_directory_path() / ("crypto_daemon_tests." + std::to_string(::getpid()))).string()
+  };
+  CryptoDaemon daemon { socket_path, TextEncoding::HEX, 2 };
+  std::jthread serving { [this] { daemon.run(); } };
+
+  void TearDown() {
+    daemon.stop();
+    serving.join();
+  }
+
+  static std::string get_error(const std::function<void()> &call) {
+    try {
+      call();
+    } catch (const CryptoError &e) {
+      EXPECT_EQ(daemon_error, e.get_error());
+      return e.what();
+    }
+    return {};
+  }
+};
+
+TEST_F(crypto_daemon_tests, frames_round_trip) {
+  std::string frames;
+  DaemonFrames::append(frames, DaemonRequest { .id = 7,
+                                               .strategy = 2,
+                                               .mode = DaemonMode::DECRYPTION,
+                                               .key_handle = 3,
+                                               .payload = "payload" });
+
+  for (std::size_t size {}; size < frames.size(); ++size) {
+    ASSERT_FALSE(DaemonFrames::parse_request(std::string_view { frames }.substr(0, size)).has_value());
+  }
+  const auto request { DaemonFrames::parse_request(frames) };
+  ASSERT_TRUE(request.has_value());
+  ASSERT_EQ(7, request->id);
+  ASSERT_EQ(2, request->strategy);
+  ASSERT_EQ(DaemonMode::DECRYPTION, request->mode);
+  ASSERT_EQ(3, request->key_handle);
+  ASSERT_EQ("payload", request->payload);
+  ASSERT_EQ(frames.size(), DaemonFrames::get_frame_size(*request));
+}
+
+TEST_F(crypto_daemon_tests, oversized_frame_is_known_from_its_size) {
+  std::string frames;
+  DaemonFrames::append(frames, DaemonResponse { .id = 1, .payload = "" });
+  const std::uint32_t size { DaemonFrames::max_payload_size + 1 };
+  std::memcpy(frames.data(), &size, sizeof(size));
+
+  ASSERT_TRUE(DaemonFrames::is_oversized(std::string_view { frames }.substr(0, 4)));
+  ASSERT_FALSE(DaemonFrames::is_oversized(std::string_view { frames }.substr(0, 3)));
+}
+
+TEST_F(crypto_daemon_tests, serves_every_strategy_like_input) {
+  DaemonClient client { socket_path };
+  auto crypto_strategies { make_crypto_strategies() };
+
+  for (auto &&[name, key] : { std::pair { "caesar", "3" }, std::pair { "vigenere", "LEMON" },
+                              std::pair { "aes", "hellohellohelloh" }, std::pair { "aes-ctr", "hellohellohelloh" },
+                              std::pair { "cascade", "vigenere:LEMON|caesar:3" } }) {
+    const auto key_handle { client.register_key(name, key) };
+
+    const auto encrypted { client.encrypt(name, key_handle, "HELLO, WORLD!") };
+
+    auto &strategy { *crypto_strategies.at(name) };
+    ASSERT_EQ("HELLO, WORLD!", strategy.decrypt(encrypted, *strategy.prepare_key(key))) << name;
+    ASSERT_EQ("HELLO, WORLD!", client.decrypt(name, key_handle, encrypted)) << name;
+  }
+}
+
+TEST_F(crypto_daemon_tests, same_key_gets_same_handle) {
+  DaemonClient first { socket_path };
+  DaemonClient second { socket_path };
+
+  ASSERT_EQ(first.register_key("vigenere", "lemon"), second.register_key("vigenere", "lemon"));
+  ASSERT_NE(first.register_key("vigenere", "lemon"), first.register_key("vigenere", "lime"));
+  ASSERT_NE(first.register_key("vigenere", "lemon"), first.register_key("caesar", "3"));
+}
+
+TEST_F(crypto_daemon_tests, key_is_released_when_its_connections_close) {
+  DaemonClient first { socket_path };
+  DaemonClient second { socket_path };
+  const auto key_handle { first.register_key("caesar", "3") };
+  ASSERT_EQ(key_handle, second.register_key("caesar", "3"));
+
+  for (auto *client : { &first, &second }) {
+    ASSERT_EQ("def", client->encrypt("caesar", key_handle, "abc"));
+    // The daemon closes the connection once it has answered everything.
+    client->shutdown_sending();
+    ASSERT_THROW(client->receive(), CryptoError);
+  }
+
+  // Handles aren't reused, so a released key comes back under a new one.
+  ASSERT_NE(key_handle, DaemonClient { socket_path }.register_key("caesar", "3"));
+}
+
+TEST_F(crypto_daemon_tests, error_when_key_handle_was_registered_by_other_connection) {
+  DaemonClient owner { socket_path };
+  DaemonClient other { socket_path };
+  const auto key_handle { owner.register_key("caesar", "3") };
+
+  ASSERT_EQ(unknown_key_handle_error, get_error([&] { other.encrypt("caesar", key_handle, "abc"); }));
+  ASSERT_EQ("def", owner.encrypt("caesar", key_handle, "abc"));
+}
+
+TEST_F(crypto_daemon_tests, socket_is_private_to_its_user) {
+  ASSERT_EQ(std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+            std::filesystem::status(socket_path).permissions());
+}
+
+TEST_F(crypto_daemon_tests, error_when_connection_registers_too_many_keys) {
+  DaemonClient client { socket_path };
+  for (std::size_t key {}; key < CryptoDaemon::max_keys_per_connection; ++key) {
+    client.register_key("caesar", std::to_string(key));
+  }
+
+  ASSERT_EQ(too_many_keys_error, get_error([&] { client.register_key("caesar", "-1"); }));
+  ASSERT_NO_THROW(client.register_key("caesar", "0"));
+  ASSERT_NO_THROW(DaemonClient { socket_path }.register_key("caesar", "-1"));
+}
+
+TEST_F(crypto_daemon_tests, pipelined_requests_are_all_answered) {
+  DaemonClient client { socket_path };
+  const auto aes { client.register_key("aes", "hellohellohelloh") };
+  const auto caesar { client.register_key("caesar", "1") };
+  constexpr std::uint32_t requests_count { 500 };
+
+  for (std::uint32_t id {}; id < requests_count; ++id) {
+    const auto is_aes { id % 2 == 0 };
+    client.send({ .id = id,
+                  .strategy = DaemonClient::get_strategy_id(is_aes ? "aes" : "caesar"),
+                  .mode = DaemonMode::ENCRYPTION,
+                  .key_handle = is_aes ? aes : caesar,
+                  .payload = is_aes ? "Hello, World!" : "HeLlO, WoRlD" });
+  }
+
+  std::vector<bool> is_answered(requests_count);
+  for (std::uint32_t count {}; count < requests_count; ++count) {
+    const auto response { client.receive() };
+    ASSERT_FALSE(response.is_error);
+    ASSERT_EQ(response.id % 2 == 0 ? "2194DE9B8F7D945524307B05D0561AF8" : "IfMmP, XpSmE", response.payload);
+    ASSERT_FALSE(is_answered.at(response.id));
+    is_answered[response.id] = true;
+  }
+}
+
+TEST_F(crypto_daemon_tests, record_error_fails_alone) {
+  DaemonClient client { socket_path };
+  const auto key_handle { client.register_key("aes", "hellohellohelloh") };
+
+  client.send({ .id = 1, .strategy = 2, .mode = DaemonMode::DECRYPTION, .key_handle = key_handle, .payload = "2194" });
+  client.send({ .id = 2,
+                .strategy = 2,
+                .mode = DaemonMode::DECRYPTION,
+                .key_handle = key_handle,
+                .payload = "2194DE9B8F7D945524307B05D0561AF8" });
+
+  for (int count {}; count < 2; ++count) {
+    const auto response { client.receive() };
+    if (response.id == 1) {
+      ASSERT_TRUE(response.is_error);
+      ASSERT_EQ(broken_ciphertext_error, response.payload);
+    } else {
+      ASSERT_FALSE(response.is_error);
+      ASSERT_EQ("Hello, World!", response.payload);
+    }
+  }
+}
+
+TEST_F(crypto_daemon_tests, error_when_key_is_invalid) {
+  DaemonClient client { socket_path };
+
+  ASSERT_THROW(client.register_key("aes", "short"), CryptoError);
+  ASSERT_EQ(key_contains_non_alphabetic_chars_error, get_error([&] { client.register_key("vigenere", "l3mon"); }));
+}
+
+TEST_F(crypto_daemon_tests, error_when_key_handle_is_unknown) {
+  DaemonClient client { socket_path };
+  const auto key_handle { client.register_key("caesar", "3") };
+
+  ASSERT_EQ(unknown_key_handle_error, get_error([&] { client.encrypt("caesar", key_handle + 1, "abc"); }));
+  ASSERT_EQ(unknown_key_handle_error, get_error([&] { client.encrypt("vigenere", key_handle, "abc"); }));
+}
+
+TEST_F(crypto_daemon_tests, error_when_strategy_or_mode_is_unknown) {
+  DaemonClient client { socket_path };
+
+  client.send({ .id = 1,
+                .strategy = static_cast<std::uint8_t>(crypto_strategies_binds.size()),
+                .mode = DaemonMode::ENCRYPTION,
+                .payload = "" });
+  ASSERT_EQ(unknown_crypto_strategy_error, client.receive().payload);
+  client.send({ .id = 2, .strategy = 0, .mode = static_cast<DaemonMode>(9), .payload = "" });
+  ASSERT_EQ(unknown_crypto_mode_error, client.receive().payload);
+}
+
+TEST_F(crypto_daemon_tests, answers_after_peer_shuts_down_its_side) {
+  DaemonClient client { socket_path };
+  const auto key_handle { client.register_key("caesar", "1") };
+
+  client.send({ .id = 5, .strategy = 0, .mode = DaemonMode::ENCRYPTION, .key_handle = key_handle, .payload = "abc" });
+  client.shutdown_sending();
+
+  const auto response { client.receive() };
+  ASSERT_EQ(5, response.id);
+  ASSERT_EQ("bcd", response.payload);
+}
+
+TEST_F(crypto_daemon_tests, error_when_socket_path_is_too_long) {
+  ASSERT_THROW(CryptoDaemon { std::string(200, 'a') }, CryptoError);
+}
+
+TEST_F(crypto_daemon_tests, socket_of_running_daemon_is_kept) {
+  ASSERT_THROW(CryptoDaemon { socket_path }, CryptoError);
+
+  DaemonClient client { socket_path };
+  ASSERT_EQ("def", client.encrypt("caesar", client.register_key("caesar", "3"), "abc"));
+}
+
+TEST_F(crypto_daemon_tests, file_at_socket_path_is_kept) {
+  const auto path { socket_path + ".file" };
+  std::ofstream { path } << "file";
+
+  ASSERT_THROW(CryptoDaemon { path }, CryptoError);
+  ASSERT_TRUE(std::filesystem::is_regular_file(path));
+  std::filesystem::remove(path);
+}
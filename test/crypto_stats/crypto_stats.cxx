@@ -0,0 +1,83 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/crypto_stats.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class crypto_stats_tests : public testing::Test {
+ public:
+  static constexpr std::array<std::string_view, 2> names { "caesar", "vigenere" };
+};
+
+TEST_F(crypto_stats_tests, empty_histogram) {
+  const LatencyHistogram histogram;
+
+  ASSERT_EQ(0, histogram.get_percentile(0.5));
+  ASSERT_EQ(0, histogram.get_max());
+}
+
+TEST_F(crypto_stats_tests, small_values_are_exact) {
+  LatencyHistogram histogram;
+  for (std::uint64_t value {}; value < 5; ++value) {
+    histogram.record(value);
+  }
+
+  ASSERT_EQ(2, histogram.get_percentile(0.5));
+  ASSERT_EQ(4, histogram.get_percentile(0.99));
+  ASSERT_EQ(4, histogram.get_max());
+}
+
+TEST_F(crypto_stats_tests, percentiles_are_within_bucket_precision) {
+  LatencyHistogram histogram;
+  for (std::uint64_t value { 1 }; value <= 10000; ++value) {
+    histogram.record(value * 1000);
+  }
+
+  ASSERT_NEAR(5'000'000, histogram.get_percentile(0.5), 5'000'000 / 8);
+  ASSERT_NEAR(9'900'000, histogram.get_percentile(0.99), 9'900'000 / 8);
+  ASSERT_EQ(10'000'000, histogram.get_max());
+}
+
+TEST_F(crypto_stats_tests, percentile_never_exceeds_max) {
+  LatencyHistogram histogram;
+  histogram.record(1'000'001);
+
+  ASSERT_EQ(1'000'001, histogram.get_percentile(0.99));
+}
+
+TEST_F(crypto_stats_tests, record_counts_calls_errors_and_bytes) {
+  CryptoStats stats { names };
+  stats.record("caesar", 10, 10, std::chrono::microseconds { 1 }, false);
+  stats.record("caesar", 5, 0, std::chrono::microseconds { 2 }, true);
+
+  const auto &actual { stats.get_strategies().at("caesar") };
+  ASSERT_EQ(2, actual.calls);
+  ASSERT_EQ(1, actual.errors);
+  ASSERT_EQ(15, actual.bytes_in);
+  ASSERT_EQ(10, actual.bytes_out);
+  ASSERT_EQ(2000, actual.latency_histogram.get_max());
+  ASSERT_EQ(0, stats.get_strategies().at("vigenere").calls);
+}
+
+TEST_F(crypto_stats_tests, unknown_strategy_is_ignored) {
+  CryptoStats stats { names };
+  stats.record("rot13", 1, 1, {}, false);
+
+  ASSERT_EQ(2, stats.get_strategies().size());
+}
+
+TEST_F(crypto_stats_tests, to_json) {
+  CryptoStats stats { names };
+  stats.record("vigenere", 3, 3, std::chrono::nanoseconds { 7 }, false);
+
+  ASSERT_EQ(
+      "{\"caesar\":{\"calls\":0,\"errors\":0,\"bytes_in\":0,\"bytes_out\":0,\"latency_ns\":{\"p50\":0,\"p99\":0,"
+      "\"max\":0}},\"vigenere\":{\"calls\":1,\"errors\":0,\"bytes_in\":3,\"bytes_out\":3,\"latency_ns\":{\"p50\":7,"
+      "\"p99\":7,\"max\":7}}}",
+      stats.to_json());
+}
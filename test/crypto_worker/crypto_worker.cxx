@@ -0,0 +1,183 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/caesar_crypto.hpp"
+#include "src/crypto_worker.hpp"
+#include "src/vigenere_crypto.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// Holds every chunk until released, so the test decides where the worker is when it gets cancelled.
+class GatedCaesarCryptoStrategy : public CaesarCryptoStrategy {
+ public:
+  class GatedStream : public CaesarCryptoStream {
+   public:
+    GatedStream(CaesarCryptoStrategy &strategy, std::atomic<bool> &is_released)
+        : CaesarCryptoStream { [&strategy](auto &&chunk, auto shift) { return strategy.encrypt(chunk, shift); } },
+          is_released { is_released } {}
+
+    std::string update(const std::string &chunk) override {
+      is_released.wait(false);
+      return CaesarCryptoStream::update(chunk);
+    }
+
+   private:
+    std::atomic<bool> &is_released;
+  };
+
+  std::unique_ptr<CryptoStream> create_encryption_stream() override {
+    return std::make_unique<GatedStream>(*this, is_released);
+  }
+
+  void release() {
+    is_released = true;
+    is_released.notify_all();
+  }
+
+  std::atomic<bool> is_released {};
+};
+
+}  // namespace
+
+class crypto_worker_tests : public Test {
+ public:
+  DataView data_view;
+  GatedCaesarCryptoStrategy *gated_caesar { new GatedCaesarCryptoStrategy };
+  std::unique_ptr<CryptoWorker> worker;
+
+  void SetUp() {
+    CryptoStrategies crypto_strategies;
+    crypto_strategies["caesar"].reset(new CaesarCryptoStrategy);
+    crypto_strategies["vigenere"].reset(new VigenereCryptoStrategy);
+    crypto_strategies["gated"].reset(gated_caesar);
+
+    worker.reset(new CryptoWorker { data_view, std::move(crypto_strategies) });
+  }
+};
+
+TEST_F(crypto_worker_tests, result_lands_in_data_view) {
+  worker->encrypt("caesar", "HeLlO, WoRlD", "1");
+  worker->wait();
+
+  ASSERT_EQ("IfMmP, XpSmE", data_view.output_text);
+  ASSERT_FALSE(data_view.has_error);
+  ASSERT_FALSE(worker->get_is_running());
+}
+
+TEST_F(crypto_worker_tests, text_larger_than_chunk_is_processed_whole) {
+  const std::string text(2 * CryptoWorker::chunk_size + 3, 'a');
+
+  worker->decrypt("vigenere", text, "b");
+  worker->wait();
+
+  ASSERT_EQ(std::string(text.size(), 'z'), data_view.output_text);
+  ASSERT_EQ(text.size(), worker->get_processed_size());
+  ASSERT_FLOAT_EQ(1.0f, worker->get_progress());
+}
+
+TEST_F(crypto_worker_tests, error_lands_in_data_view) {
+  worker->encrypt("caesar", "1", "1");
+  worker->wait();
+
+  ASSERT_THAT(data_view.output_text, HasSubstr(broken_text_error));
+  ASSERT_TRUE(data_view.has_error);
+}
+
+TEST_F(crypto_worker_tests, cancel_stops_between_chunks) {
+  worker->encrypt("gated", std::string(3 * CryptoWorker::chunk_size, 'a'), "1");
+  ASSERT_TRUE(worker->get_is_running());
+
+  worker->cancel();
+  gated_caesar->release();
+  worker->wait();
+
+  ASSERT_THAT(data_view.output_text, HasSubstr(operation_is_cancelled_error));
+  ASSERT_TRUE(data_view.has_error);
+  ASSERT_LT(worker->get_processed_size(), 3 * CryptoWorker::chunk_size);
+}
+
+TEST_F(crypto_worker_tests, stop_cancels_and_waits_for_operation) {
+  worker->encrypt("gated", std::string(3 * CryptoWorker::chunk_size, 'a'), "1");
+  const std::jthread releasing { [this] {
+    std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+    gated_caesar->release();
+  } };
+
+  worker->stop();
+
+  ASSERT_TRUE(worker->poll());
+  ASSERT_THAT(data_view.output_text, HasSubstr(operation_is_cancelled_error));
+}
+
+TEST_F(crypto_worker_tests, poll_does_nothing_while_running) {
+  worker->encrypt("gated", "abc", "1");
+
+  ASSERT_FALSE(worker->poll());
+
+  gated_caesar->release();
+  worker->wait();
+  ASSERT_EQ("bcd", data_view.output_text);
+}
+
+TEST_F(crypto_worker_tests, on_update_is_called_for_chunks_and_result) {
+  std::atomic<int> updates {};
+  worker->set_on_update([&updates] { ++updates; });
+
+  worker->encrypt("caesar", std::string(2 * CryptoWorker::chunk_size, 'a'), "1");
+  worker->wait();
+
+  ASSERT_EQ(3, updates);
+}
+
+TEST_F(crypto_worker_tests, stats_count_results_and_errors) {
+  constexpr std::array<std::string_view, 1> names { "caesar" };
+  CryptoStats stats { names };
+  worker->set_stats(&stats);
+
+  worker->encrypt("caesar", "abc", "1");
+  worker->wait();
+  worker->encrypt("caesar", "1", "1");
+  worker->wait();
+
+  const auto &actual { stats.get_strategies().at("caesar") };
+  ASSERT_EQ(2, actual.calls);
+  ASSERT_EQ(1, actual.errors);
+  ASSERT_EQ(4, actual.bytes_in);
+  ASSERT_EQ(3, actual.bytes_out);
+}
+
+TEST_F(crypto_worker_tests, crack_lands_key_and_plain_text_in_data_view) {
+  constexpr std::string_view text {
+    "it was a bright cold day in april, and the clocks were striking thirteen. the hallway smelt of boiled cabbage "
+    "and old rag mats. at one end of it a coloured poster, too large for indoor display, had been tacked to the "
+    "wall. it depicted simply an enormous face, more than a metre wide: the face of a man of about forty-five, with "
+    "a heavy black moustache and ruggedly handsome features. he made for the stairs. it was no use trying the lift. "
+    "even at the best of times it was seldom working, and at present the electric current was cut off during "
+    "daylight hours. it was part of the economy drive in preparation for hate week."
+  };
+  VigenereCryptoStrategy strategy;
+
+  worker->crack("vigenere", strategy.encrypt(std::string { text }, std::any { "key" }));
+  worker->wait();
+
+  ASSERT_EQ("key", data_view.cracked_key);
+  ASSERT_EQ(text, data_view.output_text);
+  ASSERT_FALSE(data_view.has_error);
+}
+
+TEST_F(crypto_worker_tests, cracked_key_is_cleared_by_next_result) {
+  data_view.cracked_key = "key";
+
+  worker->encrypt("caesar", "abc", "1");
+  worker->wait();
+
+  ASSERT_TRUE(data_view.cracked_key.empty());
+}
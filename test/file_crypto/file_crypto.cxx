@@ -0,0 +1,138 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "src/caesar_crypto.hpp"
+#include "src/file_crypto.hpp"
+#include "src/vigenere_crypto.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class file_crypto_tests : public testing::Test {
+ public:
+  const std::filesystem::path directory { std::filesystem::temp_directory_path() / "file_crypto_tests" };
+  const std::string input_path { directory / "input.txt" };
+  const std::string output_path { directory / "output.txt" };
+  // Not the mode a temporary file is created with, so the test sees whether it is carried over.
+  static constexpr auto private_perms { std::filesystem::perms::owner_read | std::filesystem::perms::owner_write |
+                                        std::filesystem::perms::group_read };
+
+  void SetUp() override { std::filesystem::create_directories(directory); }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  static void write_file(const std::string &path, const std::string &text) {
+    std::ofstream { path, std::ios::binary } << text;
+  }
+
+  static std::string read_file(const std::string &path) {
+    std::ifstream file { path, std::ios::binary };
+    return { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+  }
+};
+
+TEST_F(file_crypto_tests, caesar_encrypts_file_into_other_file) {
+  CaesarCryptoStrategy crypto;
+  write_file(input_path, "HeLlO, WoRlD");
+
+  const auto report { FileCrypto::encrypt(crypto, "1", input_path, output_path) };
+
+  ASSERT_EQ("IfMmP, XpSmE", read_file(output_path));
+  ASSERT_EQ(12, report.bytes_in);
+  ASSERT_EQ(12, report.bytes_out);
+}
+
+TEST_F(file_crypto_tests, vigenere_decrypts_file_in_place) {
+  VigenereCryptoStrategy crypto;
+  write_file(input_path, "ICPMM, APPPE!");
+
+  FileCrypto::decrypt(crypto, "BYE", input_path, input_path);
+
+  ASSERT_EQ("HELLO, WORLD!", read_file(input_path));
+}
+
+TEST_F(file_crypto_tests, vigenere_encrypts_large_file) {
+  VigenereCryptoStrategy crypto;
+  std::string text;
+  for (std::size_t i {}; text.size() < (1 << 20); ++i) {
+    text += "HELLO, WORLD! ";
+  }
+  write_file(input_path, text);
+
+  FileCrypto::encrypt(crypto, "BYE", input_path, output_path);
+
+  ASSERT_EQ(crypto.encrypt(text, "BYE"), read_file(output_path));
+}
+
+TEST_F(file_crypto_tests, empty_file_gives_empty_output) {
+  CaesarCryptoStrategy crypto;
+  write_file(input_path, "");
+
+  FileCrypto::encrypt(crypto, "1", input_path, output_path);
+
+  ASSERT_EQ("", read_file(output_path));
+}
+
+TEST_F(file_crypto_tests, error_when_input_file_is_missing) {
+  CaesarCryptoStrategy crypto;
+
+  ASSERT_ANY_THROW(FileCrypto::encrypt(crypto, "1", input_path, output_path));
+}
+
+TEST_F(file_crypto_tests, failed_in_place_decryption_leaves_file_intact) {
+  VigenereCryptoStrategy crypto;
+  write_file(input_path, "ICPMM, APPPE! icpmm");
+
+  ASSERT_ANY_THROW(FileCrypto::decrypt(crypto, "BYE", input_path, input_path));
+
+  ASSERT_EQ("ICPMM, APPPE! icpmm", read_file(input_path));
+  ASSERT_EQ(1, std::distance(std::filesystem::directory_iterator { directory }, {}));
+}
+
+TEST_F(file_crypto_tests, failed_encryption_keeps_old_output_and_leaves_no_file_behind) {
+  VigenereCryptoStrategy crypto;
+  write_file(input_path, "HI");
+  write_file(output_path, "old output");
+
+  ASSERT_ANY_THROW(FileCrypto::encrypt(crypto, "BYE", input_path, output_path));
+
+  ASSERT_EQ("old output", read_file(output_path));
+  ASSERT_EQ(2, std::distance(std::filesystem::directory_iterator { directory }, {}));
+}
+
+TEST_F(file_crypto_tests, error_when_key_is_invalid_creates_no_output) {
+  VigenereCryptoStrategy crypto;
+  write_file(input_path, "HELLO");
+
+  ASSERT_ANY_THROW(FileCrypto::encrypt(crypto, "B1E", input_path, output_path));
+
+  ASSERT_FALSE(std::filesystem::exists(output_path));
+}
+
+TEST_F(file_crypto_tests, mode_survives_in_place_encryption) {
+  CaesarCryptoStrategy crypto;
+  write_file(input_path, "HeLlO, WoRlD");
+  std::filesystem::permissions(input_path, private_perms);
+
+  FileCrypto::encrypt(crypto, "1", input_path, input_path);
+
+  ASSERT_EQ("IfMmP, XpSmE", read_file(input_path));
+  ASSERT_EQ(private_perms, std::filesystem::status(input_path).permissions());
+}
+
+TEST_F(file_crypto_tests, new_output_gets_mode_of_input) {
+  CaesarCryptoStrategy crypto;
+  write_file(input_path, "HeLlO, WoRlD");
+  std::filesystem::permissions(input_path, private_perms);
+
+  FileCrypto::encrypt(crypto, "1", input_path, output_path);
+
+  ASSERT_EQ(private_perms, std::filesystem::status(output_path).permissions());
+}
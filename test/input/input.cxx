@@ -77,4 +77,11 @@ TEST_F(crypto_input_tests, data_view_can_contain_exсeptions_text_when_decryptio
   input->decrypt("caesar", "1", "1");
 
   ASSERT_THAT(data_view.output_text, HasSubstr(broken_text_error));
-}
\ No newline at end of file
+}
+
+TEST_F(crypto_input_tests, data_view_contains_error_when_strategy_is_unknown) {
+  input->encrypt("rot13", "hello", "1");
+
+  ASSERT_TRUE(data_view.has_error);
+  ASSERT_THAT(data_view.output_text, HasSubstr(unknown_crypto_strategy_error));
+}
@@ -0,0 +1,94 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "src/key_schedule_cache.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// Counts key expansions and rejects empty keys like a real cipher rejects invalid lengths.
+struct CountingSchedule {
+  inline static int expansions {};
+
+  void SetKey(const CryptoPP::byte *key, std::size_t size) {
+    if (size == 0) {
+      throw std::invalid_argument { "empty key" };
+    }
+
+    ++expansions;
+    first_byte = key[0];
+  }
+
+  CryptoPP::byte first_byte {};
+};
+
+}  // namespace
+
+class key_schedule_cache_tests : public testing::Test {
+ public:
+  void SetUp() override { CountingSchedule::expansions = 0; }
+
+  KeyScheduleCache<CountingSchedule> cache { 2 };
+};
+
+TEST_F(key_schedule_cache_tests, repeated_key_is_expanded_once) {
+  cache.get("hellohellohelloh");
+  cache.get("hellohellohelloh");
+
+  ASSERT_EQ(1, CountingSchedule::expansions);
+  ASSERT_EQ(1, cache.get_stats().hits);
+  ASSERT_EQ(1, cache.get_stats().misses);
+}
+
+TEST_F(key_schedule_cache_tests, different_keys_get_different_schedules) {
+  ASSERT_EQ('a', cache.get("aaaa").first_byte);
+  ASSERT_EQ('b', cache.get("bbbb").first_byte);
+  ASSERT_EQ(2, cache.size());
+}
+
+TEST_F(key_schedule_cache_tests, least_recently_used_key_is_evicted) {
+  cache.get("aaaa");
+  cache.get("bbbb");
+  cache.get("aaaa");
+  cache.get("cccc");
+
+  cache.get("aaaa");
+  ASSERT_EQ(3, CountingSchedule::expansions);
+  cache.get("bbbb");
+  ASSERT_EQ(4, CountingSchedule::expansions);
+  ASSERT_EQ(2, cache.get_stats().evictions);
+}
+
+TEST_F(key_schedule_cache_tests, evict_forgets_key) {
+  cache.get("aaaa");
+
+  ASSERT_TRUE(cache.evict("aaaa"));
+  ASSERT_FALSE(cache.evict("aaaa"));
+  ASSERT_EQ(0, cache.size());
+
+  cache.get("aaaa");
+  ASSERT_EQ(2, CountingSchedule::expansions);
+}
+
+TEST_F(key_schedule_cache_tests, invalid_key_is_not_cached) {
+  ASSERT_ANY_THROW(cache.get(""));
+  ASSERT_EQ(0, cache.size());
+  ASSERT_EQ(1, cache.get_stats().misses);
+}
+
+TEST_F(key_schedule_cache_tests, clear_drops_all_keys) {
+  cache.get("aaaa");
+  cache.get("bbbb");
+
+  cache.clear();
+
+  ASSERT_EQ(0, cache.size());
+  ASSERT_EQ(2, cache.get_stats().evictions);
+}
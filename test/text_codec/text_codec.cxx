@@ -0,0 +1,131 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/text_codec.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class text_codec_tests : public Test {
+ public:
+  static std::string make_bytes(std::size_t size) {
+    std::string bytes(size, '\0');
+    for (std::size_t i {}; i < size; ++i) {
+      bytes[i] = static_cast<char>(i * 37 + i / 7);
+    }
+    return bytes;
+  }
+
+  static std::string encode(const TextCodec &codec, std::string_view bytes) {
+    std::string encoded(codec.get_encoded_size(bytes.size()), '\0');
+    codec.encode(reinterpret_cast<const std::uint8_t *>(bytes.data()), bytes.size(), encoded.data());
+    return encoded;
+  }
+
+  static std::optional<std::string> decode(const TextCodec &codec, std::string_view encoded) {
+    std::string decoded(codec.get_max_decoded_size(encoded.size()), '\0');
+    const auto size { codec.decode(encoded.data(), encoded.size(), reinterpret_cast<std::uint8_t *>(decoded.data())) };
+    if (size.has_value() == false) {
+      return std::nullopt;
+    }
+
+    decoded.resize(*size);
+    return decoded;
+  }
+};
+
+TEST_F(text_codec_tests, base64_matches_rfc_4648_vectors) {
+  const TextCodec codec { TextEncoding::BASE64 };
+  const std::array<std::pair<std::string_view, std::string_view>, 7> vectors {
+    { { "", "" },
+      { "f", "Zg==" },
+      { "fo", "Zm8=" },
+      { "foo", "Zm9v" },
+      { "foob", "Zm9vYg==" },
+      { "fooba", "Zm9vYmE=" },
+      { "foobar", "Zm9vYmFy" } }
+  };
+
+  for (auto &&[bytes, encoded] : vectors) {
+    ASSERT_EQ(encoded, encode(codec, bytes));
+    ASSERT_EQ(bytes, decode(codec, encoded));
+  }
+}
+
+TEST_F(text_codec_tests, hex_is_upper_case_and_decodes_either_case) {
+  const TextCodec codec { TextEncoding::HEX };
+
+  ASSERT_EQ("00FF7A", encode(codec, std::string_view { "\x00\xff\x7a", 3 }));
+  ASSERT_EQ(std::string_view("\x00\xff\x7a", 3), decode(codec, "00fF7a"));
+}
+
+TEST_F(text_codec_tests, vector_kernels_match_scalar) {
+  for (auto &&size : { 0, 1, 15, 16, 17, 31, 32, 33, 47, 64, 100, 1000, 4099 }) {
+    const auto bytes { make_bytes(size) };
+    const auto *data { reinterpret_cast<const std::uint8_t *>(bytes.data()) };
+    std::string hex(2 * size, '\0');
+    std::string base64(Base64Codec::get_encoded_size(size), '\0');
+    HexCodec::encode_scalar(data, size, hex.data());
+    Base64Codec::encode_scalar(data, size, base64.data());
+
+    ASSERT_EQ(hex, encode(TextCodec { TextEncoding::HEX }, bytes));
+    ASSERT_EQ(base64, encode(TextCodec { TextEncoding::BASE64 }, bytes));
+    ASSERT_EQ(bytes, decode(TextCodec { TextEncoding::HEX }, hex));
+    ASSERT_EQ(bytes, decode(TextCodec { TextEncoding::BASE64 }, base64));
+  }
+}
+
+TEST_F(text_codec_tests, round_trip_in_every_encoding) {
+  const auto bytes { make_bytes(777) };
+
+  for (auto &&encoding : { TextEncoding::RAW, TextEncoding::HEX, TextEncoding::BASE64 }) {
+    const TextCodec codec { encoding };
+
+    ASSERT_EQ(bytes, decode(codec, encode(codec, bytes)));
+  }
+}
+
+TEST_F(text_codec_tests, groups_encode_separately) {
+  const TextCodec codec { TextEncoding::BASE64 };
+  const auto bytes { make_bytes(100) };
+  const auto split { 20 * codec.get_group_size() };
+
+  ASSERT_EQ(encode(codec, bytes),
+            encode(codec, std::string_view { bytes }.substr(0, split)) +
+                encode(codec, std::string_view { bytes }.substr(split)));
+}
+
+TEST_F(text_codec_tests, error_when_char_is_not_in_encoding) {
+  for (auto &&position : { 0, 5, 40, 99 }) {
+    auto hex { encode(TextCodec { TextEncoding::HEX }, make_bytes(50)) };
+    auto base64 { encode(TextCodec { TextEncoding::BASE64 }, make_bytes(75)) };
+    hex[position] = 'G';
+    base64[position] = '.';
+
+    ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::HEX }, hex));
+    ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::BASE64 }, base64));
+  }
+}
+
+TEST_F(text_codec_tests, error_when_size_is_not_whole_groups) {
+  ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::HEX }, "ABC"));
+  ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::BASE64 }, "Zm9vY"));
+}
+
+TEST_F(text_codec_tests, error_when_padding_is_not_last) {
+  ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::BASE64 }, "Zg==Zm9v"));
+  ASSERT_EQ(std::nullopt, decode(TextCodec { TextEncoding::BASE64 }, "Zh=="));
+}
+
+TEST_F(text_codec_tests, parse_encoding_names) {
+  ASSERT_EQ(TextEncoding::RAW, TextCodec::parse("raw"));
+  ASSERT_EQ(TextEncoding::BASE64, TextCodec::parse("base64"));
+  ASSERT_EQ(std::nullopt, TextCodec::parse("base32"));
+}
@@ -0,0 +1,56 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/text_rows.hpp"
+
+int main() {
+  testing::InitGoogleTest();
+  testing::InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class text_rows_tests : public testing::Test {
+ public:
+  TextRows rows;
+};
+
+TEST_F(text_rows_tests, split_at_newlines) {
+  const std::string text { "Hello,\nWorld!\n\nBye" };
+
+  rows.build(text, 80);
+
+  ASSERT_EQ(4, rows.size());
+  ASSERT_EQ("Hello,", rows.get_row(text, 0));
+  ASSERT_EQ("World!", rows.get_row(text, 1));
+  ASSERT_EQ("", rows.get_row(text, 2));
+  ASSERT_EQ("Bye", rows.get_row(text, 3));
+}
+
+TEST_F(text_rows_tests, wrap_long_lines) {
+  const std::string text { "0123456789ABCDEF01" };
+
+  rows.build(text, 8);
+
+  ASSERT_EQ(3, rows.size());
+  ASSERT_EQ("01234567", rows.get_row(text, 0));
+  ASSERT_EQ("89ABCDEF", rows.get_row(text, 1));
+  ASSERT_EQ("01", rows.get_row(text, 2));
+}
+
+TEST_F(text_rows_tests, newline_right_after_full_row) {
+  const std::string text { "01234567\n89" };
+
+  rows.build(text, 8);
+
+  ASSERT_EQ(2, rows.size());
+  ASSERT_EQ("01234567", rows.get_row(text, 0));
+  ASSERT_EQ("89", rows.get_row(text, 1));
+}
+
+TEST_F(text_rows_tests, empty_text_has_no_rows) {
+  rows.build("", 8);
+
+  ASSERT_EQ(0, rows.size());
+}
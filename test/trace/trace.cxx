@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "src/trace.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class trace_tests : public Test {
+ public:
+  Tracer &tracer { Tracer::get_instance() };
+
+  void SetUp() {
+    tracer.clear();
+    tracer.set_enabled(true);
+  }
+
+  void TearDown() { tracer.set_enabled(false); }
+
+  static std::size_t count(const std::string &text, const std::string &pattern) {
+    std::size_t result {};
+    for (auto pos { text.find(pattern) }; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+      ++result;
+    }
+    return result;
+  }
+};
+
+TEST_F(trace_tests, span_is_recorded_as_complete_event) {
+  { const TraceSpan span { "stage" }; }
+
+  const auto actual { tracer.to_json() };
+  ASSERT_THAT(actual, StartsWith("{\"traceEvents\":[{\"name\":\"stage\",\"cat\":\"crypto\",\"ph\":\"X\",\"ts\":"));
+  ASSERT_THAT(actual, HasSubstr("\"dropped_events\":0"));
+}
+
+TEST_F(trace_tests, nothing_is_recorded_when_disabled) {
+  tracer.set_enabled(false);
+  { const TraceSpan span { "stage" }; }
+
+  ASSERT_EQ(0, count(tracer.to_json(), "\"ph\":\"X\""));
+}
+
+TEST_F(trace_tests, nested_spans_are_recorded_inner_first) {
+  {
+    const TraceSpan outer { "outer" };
+    const TraceSpan inner { "inner" };
+  }
+
+  const auto actual { tracer.to_json() };
+  ASSERT_LT(actual.find("inner"), actual.find("outer"));
+}
+
+TEST_F(trace_tests, threads_record_into_their_own_buffers) {
+  { const TraceSpan span { "main" }; }
+  std::jthread { [] { const TraceSpan span { "first" }; } }.join();
+
+  const auto actual { tracer.to_json() };
+  ASSERT_EQ(2, count(actual, "\"ph\":\"X\""));
+  ASSERT_EQ(1, count(actual, "\"tid\":0"));
+  ASSERT_EQ(1, count(actual, "\"tid\":1"));
+}
+
+TEST_F(trace_tests, buffer_of_finished_thread_is_reused) {
+  { const TraceSpan span { "main" }; }
+  std::jthread { [] { const TraceSpan span { "first" }; } }.join();
+  std::jthread { [] { const TraceSpan span { "second" }; } }.join();
+
+  const auto actual { tracer.to_json() };
+  ASSERT_EQ(3, count(actual, "\"ph\":\"X\""));
+  ASSERT_EQ(0, count(actual, "\"tid\":2"));
+}
+
+TEST_F(trace_tests, events_past_capacity_overwrite_oldest) {
+  for (std::size_t i {}; i < 3; ++i) {
+    const TraceSpan span { "old_stage" };
+  }
+  for (std::size_t i {}; i < TraceBuffer::capacity; ++i) {
+    const TraceSpan span { "new_stage" };
+  }
+
+  const auto actual { tracer.to_json() };
+  ASSERT_EQ(TraceBuffer::capacity, count(actual, "\"name\":\"new_stage\""));
+  ASSERT_EQ(0, count(actual, "old_stage"));
+  ASSERT_THAT(actual, HasSubstr("\"dropped_events\":3"));
+}
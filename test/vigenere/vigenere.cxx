@@ -74,4 +74,157 @@ TEST_F(vigenere_encrypt_tests, error_when_case_is_different_in_text) {
 
 TEST_F(vigenere_encrypt_tests, error_when_case_is_different_in_key) {
   ASSERT_ANY_THROW(crypto.encrypt("HeLlo, world!", "bYe"));
-}
\ No newline at end of file
+}
+
+TEST_F(vigenere_encrypt_tests, stream_carries_key_position_across_chunks) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin("BYE");
+
+  auto actual { stream->update("HEL") };
+  actual += stream->update("LO, W");
+  actual += stream->update("ORLD!");
+  actual += stream->finish();
+
+  ASSERT_EQ("ICPMM, APPPE!", actual);
+}
+
+TEST_F(vigenere_decrypt_tests, stream_carries_key_position_across_chunks) {
+  const auto stream { crypto.create_decryption_stream() };
+  stream->begin("bye");
+
+  auto actual { stream->update("icpmm, a") };
+  actual += stream->update("pppe!");
+  actual += stream->finish();
+
+  ASSERT_EQ("hello, world!", actual);
+}
+
+TEST_F(vigenere_encrypt_tests, stream_error_when_case_is_different_in_later_chunk) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin("bye");
+  stream->update("hello, ");
+
+  ASSERT_ANY_THROW(stream->update("World!"));
+}
+
+TEST_F(vigenere_encrypt_tests, stream_error_when_key_is_longer_than_text) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin("HELLO");
+
+  ASSERT_TRUE(stream->update("BYE").empty());
+  ASSERT_ANY_THROW(stream->finish());
+}
+
+TEST_F(vigenere_encrypt_tests, stream_holds_output_until_text_is_as_long_as_key) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin("BYE");
+
+  auto actual { stream->update("HE") };
+  ASSERT_TRUE(actual.empty());
+  actual += stream->update("LLO, WORLD!");
+  actual += stream->finish();
+
+  ASSERT_EQ("ICPMM, APPPE!", actual);
+}
+
+TEST_F(vigenere_encrypt_tests, case_error_wins_over_broken_text) {
+  try {
+    crypto.encrypt("hello 1 World", "bye");
+    FAIL();
+  } catch (const std::exception &e) {
+    ASSERT_THAT(e.what(), testing::HasSubstr(case_is_different_error));
+  }
+}
+
+TEST_F(vigenere_encrypt_tests, error_when_key_is_empty) { ASSERT_ANY_THROW(crypto.encrypt("HELLO", "")); }
+
+TEST_F(vigenere_decrypt_tests, decrypt_long_text_with_short_and_long_keys) {
+  std::string text;
+  for (auto i { 0 }; i < 20; ++i) {
+    text += "the quick brown fox, jumps over the lazy dog! ";
+  }
+
+  const std::string long_key(80, 'k');
+  for (auto &&key : { "b", "lemon", long_key.c_str() }) {
+    ASSERT_EQ(text, crypto.decrypt(crypto.encrypt(text, key), key)) << key;
+  }
+}
+
+#ifdef CRYPTO_X86_KERNELS
+TEST_F(vigenere_encrypt_tests, vector_kernel_matches_scalar_kernel) {
+  std::string text;
+  for (auto i { 0 }; i < 20; ++i) {
+    text += "ATTACK AT DAWN, HOLD THE BRIDGE! WAIT\tFOR ORDERS... ";
+  }
+
+  for (auto &&key : { "LEMON", "B", "QWERTYUIOPASDFGHJ" }) {
+    const auto kernel { VigenereKernel::for_encryption(key) };
+    std::string expected(text.size(), '\0');
+    std::string actual(text.size(), '\0');
+    VigenereKernel::State expected_state;
+    VigenereKernel::State actual_state;
+
+    ASSERT_EQ(VigenereKernel::Status::OK,
+              kernel.transform_scalar(text.data(), expected.data(), text.size(), expected_state));
+    ASSERT_EQ(VigenereKernel::Status::OK,
+              kernel.transform_ssse3(text.data(), actual.data(), text.size(), actual_state));
+    ASSERT_EQ(expected, actual) << key;
+    ASSERT_EQ(expected_state.key_position, actual_state.key_position);
+  }
+}
+#endif
+
+TEST_F(vigenere_encrypt_tests, prepared_key_is_reused) {
+  const auto key { crypto.prepare_key("LEMON") };
+
+  ASSERT_EQ("LXFOPVEFRNHR", crypto.encrypt("ATTACKATDAWN", *key));
+  ASSERT_EQ("ATTACKATDAWN", crypto.decrypt("LXFOPVEFRNHR", *key));
+}
+
+TEST_F(vigenere_encrypt_tests, error_when_prepared_key_contains_not_only_alphabet) {
+  ASSERT_ANY_THROW(crypto.prepare_key("BYE!"));
+}
+
+TEST_F(vigenere_encrypt_tests, error_when_prepared_key_is_longer_than_text) {
+  const auto key { crypto.prepare_key("HELLO") };
+
+  ASSERT_ANY_THROW(crypto.encrypt("BYE", *key));
+}
+
+TEST_F(vigenere_encrypt_tests, encrypt_in_place) {
+  const auto key { crypto.prepare_key("LEMON") };
+  std::string text { "ATTACKATDAWN" };
+
+  crypto.encrypt_in_place(std::as_writable_bytes(std::span { text }), *key);
+
+  ASSERT_EQ("LXFOPVEFRNHR", text);
+}
+
+TEST_F(vigenere_decrypt_tests, decrypt_into_output_buffer) {
+  const auto key { crypto.prepare_key("BYE") };
+  std::array<std::byte, 32> output;
+
+  const auto size { crypto.decrypt_into(std::as_bytes(std::span { "ICPMM, APPPE!", 13 }), output, *key) };
+
+  ASSERT_EQ("HELLO, WORLD!", std::string_view(reinterpret_cast<char *>(output.data()), size));
+}
+
+TEST_F(vigenere_encrypt_tests, try_encrypt_returns_output) {
+  const auto key { crypto.prepare_key("LEMON") };
+
+  ASSERT_EQ("LXFOPVEFRNHR", crypto.try_encrypt("ATTACKATDAWN", *key).value());
+}
+
+TEST_F(vigenere_encrypt_tests, try_encrypt_returns_error_codes_without_throwing) {
+  const auto key { crypto.prepare_key("LEMON") };
+
+  ASSERT_EQ(case_is_different_error, crypto.try_encrypt("ATTACK at dawn", *key).error());
+  ASSERT_EQ(broken_text_error, crypto.try_encrypt("attack at 5", *crypto.prepare_key("lemon")).error());
+  ASSERT_EQ(key_longer_than_text_error, crypto.try_encrypt("AT", *key).error());
+}
+
+TEST_F(vigenere_decrypt_tests, try_decrypt_returns_output) {
+  const auto key { crypto.prepare_key("LEMON") };
+
+  ASSERT_EQ("ATTACKATDAWN", crypto.try_decrypt("LXFOPVEFRNHR", *key).value());
+}
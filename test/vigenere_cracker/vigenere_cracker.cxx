@@ -0,0 +1,175 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "src/crackers.hpp"
+
+using namespace testing;
+
+int main() {
+  InitGoogleTest();
+  InitGoogleMock();
+  return RUN_ALL_TESTS();
+}
+
+class vigenere_cracker_tests : public Test {
+ public:
+  static constexpr std::string_view plain_text {
+    "the river ran slowly through the old town, past the mill and the market, where the traders of the valley "
+    "had met every week for as long as anyone could remember. in the morning the square was full of carts and "
+    "voices; by evening only the swallows were left, circling above the roofs while the last light faded behind "
+    "the hills. the people of the town were proud of their bridge, which had been built of grey stone by their "
+    "grandfathers and had survived every flood since. children ran across it on their way to school, and old men "
+    "sat on its low walls to watch the water and talk about the weather, the harvest and the price of bread. "
+    "nobody remembered who had first planted the great oak that stood at the far end of the bridge, but everyone "
+    "agreed that the town would not be the same without it. when a storm broke one of its branches, half of the "
+    "town came out to look at the damage, and the carpenter made a bench from the fallen wood so that travellers "
+    "could rest in the shade. strangers who passed through often said that nothing ever happened there, and "
+    "perhaps they were right, but the people who lived in the town would not have changed it for any city in "
+    "the world. they knew the name of every family, the story of every house and the sound of every bell, and "
+    "in the long winter evenings they told those stories again to anyone who would listen."
+  };
+
+  VigenereCryptoStrategy strategy;
+  VigenereCracker cracker { 4 };
+
+  std::string encrypt(std::string_view text, const char *key) {
+    return strategy.encrypt(std::string { text }, std::any { key });
+  }
+
+  static std::string to_upper(std::string_view text) {
+    std::string result { text };
+    std::ranges::transform(result, result.begin(), [](char ch) { return static_cast<char>(std::toupper(ch)); });
+    return result;
+  }
+};
+
+TEST_F(vigenere_cracker_tests, recover_key_of_english_text) {
+  const auto actual { cracker.crack(encrypt(plain_text, "lemonade")) };
+
+  ASSERT_EQ("lemonade", actual.key);
+  ASSERT_EQ(plain_text, actual.plain_text);
+}
+
+TEST_F(vigenere_cracker_tests, key_is_in_case_of_text) {
+  const auto text { to_upper(plain_text) };
+
+  const auto actual { cracker.crack(encrypt(text, "SECRET")) };
+
+  ASSERT_EQ("SECRET", actual.key);
+  ASSERT_EQ(text, actual.plain_text);
+}
+
+TEST_F(vigenere_cracker_tests, recover_keys_of_different_lengths) {
+  for (auto &&key : { "k", "go", "cat", "bridge", "swallows", "grandfathers" }) {
+    ASSERT_EQ(key, cracker.find_key(encrypt(plain_text, key)));
+  }
+}
+
+TEST_F(vigenere_cracker_tests, estimate_key_length_without_multiples) {
+  const auto letters { VigenereCracker::extract_letters(encrypt(plain_text, "oxford")) };
+
+  ASSERT_EQ(6, cracker.estimate_key_length(letters));
+}
+
+TEST_F(vigenere_cracker_tests, same_key_with_one_thread) {
+  const auto cipher_text { encrypt(plain_text, "harvest") };
+
+  ASSERT_EQ(cracker.find_key(cipher_text), VigenereCracker { 1 }.find_key(cipher_text));
+}
+
+TEST_F(vigenere_cracker_tests, extract_lowercase_letters) {
+  ASSERT_EQ("helloworld", VigenereCracker::extract_letters("Hello, World!\n"));
+}
+
+TEST_F(vigenere_cracker_tests, reduce_key_to_period) {
+  ASSERT_EQ("ab", VigenereCracker::reduce_to_period("ababab"));
+  ASSERT_EQ("k", VigenereCracker::reduce_to_period("kkkk"));
+  ASSERT_EQ("abca", VigenereCracker::reduce_to_period("abca"));
+}
+
+TEST_F(vigenere_cracker_tests, error_when_text_has_too_few_letters) {
+  try {
+    cracker.crack("abc, def!");
+    FAIL();
+  } catch (const CryptoError &e) {
+    ASSERT_EQ(not_enough_letters_error, e.get_error());
+  }
+}
+
+TEST_F(vigenere_cracker_tests, error_when_text_is_broken) {
+  ASSERT_ANY_THROW(cracker.crack(encrypt(plain_text, "lemon") + "1"));
+}
+
+TEST_F(vigenere_cracker_tests, coincidences_match_scalar) {
+  const auto letters { VigenereCracker::extract_letters(encrypt(plain_text, "lemon")) };
+
+  for (std::size_t shift { 1 }; shift <= 40; ++shift) {
+    ASSERT_EQ(VigenereCracker::count_coincidences_scalar(letters, shift),
+              VigenereCracker::count_coincidences(letters, shift));
+  }
+}
+
+TEST_F(vigenere_cracker_tests, histogram_matches_scalar) {
+  std::string text;
+  for (auto i { 0 }; i < 10000; ++i) {
+    text += static_cast<char>(i * 7 % 256);
+  }
+
+  for (auto &&size : { 0, 15, 33, 4095, 10000 }) {
+    LetterHistogram::Counts expected {};
+    LetterHistogram::count_scalar(std::string_view { text }.substr(0, size), expected);
+
+    ASSERT_EQ(expected, LetterHistogram::count(std::string_view { text }.substr(0, size)));
+  }
+}
+
+TEST_F(vigenere_cracker_tests, english_is_closest_without_shift) {
+  const auto counts { LetterHistogram::count(plain_text) };
+
+  for (auto shift { 1 }; shift < 26; ++shift) {
+    ASSERT_LT(LetterHistogram::chi_squared(counts, 0), LetterHistogram::chi_squared(counts, shift));
+  }
+}
+
+TEST_F(vigenere_cracker_tests, crack_file) {
+  const auto directory { std::filesystem::temp_directory_path() / "vigenere_cracker_tests" };
+  std::filesystem::create_directories(directory);
+  const std::string input_path { directory / "input.txt" };
+  const std::string output_path { directory / "output.txt" };
+  std::ofstream { input_path, std::ios::binary } << encrypt(plain_text, "river");
+
+  const auto actual { Crackers::crack_file("vigenere", input_path, output_path) };
+  std::ifstream output { output_path, std::ios::binary };
+  const std::string output_text { std::istreambuf_iterator<char> { output }, std::istreambuf_iterator<char> {} };
+  std::filesystem::remove_all(directory);
+
+  ASSERT_EQ("river", actual.key);
+  ASSERT_EQ(plain_text, output_text);
+}
+
+TEST_F(vigenere_cracker_tests, error_when_strategy_has_no_cracker) {
+  try {
+    Crackers::crack("aes", "text");
+    FAIL();
+  } catch (const CryptoError &e) {
+    ASSERT_EQ(crack_is_not_supported_error, e.get_error());
+  }
+}
+
+TEST_F(vigenere_cracker_tests, error_when_stop_is_requested) {
+  std::stop_source stop_source;
+  stop_source.request_stop();
+
+  for (auto &&name : { "caesar", "vigenere" }) {
+    try {
+      Crackers::crack(name, "text", stop_source.get_token());
+      FAIL() << name;
+    } catch (const CryptoError &e) {
+      ASSERT_EQ(operation_is_cancelled_error, e.get_error()) << name;
+    }
+  }
+}
@@ -1,7 +1,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 #include "src/caesar_crypto.hpp"
+#include "src/vigenere_crypto.hpp"
 
 int main() {
   testing::InitGoogleTest();
@@ -51,3 +54,149 @@ TEST_F(caesar_decrypt_tests, decrypt_different_case_with_twenty_six_shift) {
 
   ASSERT_EQ("HeLlO, WoRlD", actual);
 }
+
+TEST_F(caesar_encrypt_tests, stream_encrypts_chunks_like_whole_text) {
+  const auto stream { crypto.create_encryption_stream() };
+  stream->begin(1);
+
+  auto actual { stream->update("HeLlO,") };
+  actual += stream->update(" WoRlD");
+  actual += stream->finish();
+
+  ASSERT_EQ("IfMmP, XpSmE", actual);
+}
+
+TEST_F(caesar_decrypt_tests, chunked_transfer_decrypts_input_stream) {
+  const auto stream { crypto.create_decryption_stream() };
+  std::istringstream in { "IfMmP, XpSmE" };
+  std::ostringstream out;
+
+  ChunkedTransfer::run(*stream, 1, in, out, 5);
+
+  ASSERT_EQ("HeLlO, WoRlD", out.str());
+}
+
+TEST_F(caesar_encrypt_tests, throw_exception_when_digit_is_inside_long_text) {
+  std::string text(100, 'a');
+  text[70] = '7';
+
+  ASSERT_ANY_THROW(crypto.encrypt(text, 3));
+}
+
+TEST_F(caesar_decrypt_tests, decrypt_long_text_encrypted_with_every_shift) {
+  std::string text;
+  for (auto i { 0 }; i < 10; ++i) {
+    text += "The quick brown fox, jumps over the lazy dog! {THE END}\t";
+  }
+
+  for (auto shift { 0 }; shift <= 60; ++shift) {
+    ASSERT_EQ(text, crypto.decrypt(crypto.encrypt(text, shift), shift)) << shift;
+  }
+}
+
+#ifdef CRYPTO_X86_KERNELS
+TEST_F(caesar_encrypt_tests, vector_kernels_match_scalar_kernel) {
+  std::string text;
+  for (auto i { 0 }; i < 10; ++i) {
+    text += "HeLlO, WoRlD! abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ ~[]";
+  }
+
+  for (auto shift { -52 }; shift <= 52; ++shift) {
+    const auto kernel { CaesarKernel::for_encryption(shift) };
+    std::string expected(text.size(), '\0');
+    std::string sse2(text.size(), '\0');
+    std::string avx2(text.size(), '\0');
+
+    ASSERT_TRUE(kernel.transform_scalar(text.data(), expected.data(), text.size()));
+    ASSERT_TRUE(kernel.transform_sse2(text.data(), sse2.data(), text.size()));
+    ASSERT_EQ(expected, sse2) << shift;
+    if (CpuFeatures::has_avx2()) {
+      ASSERT_TRUE(kernel.transform_avx2(text.data(), avx2.data(), text.size()));
+      ASSERT_EQ(expected, avx2) << shift;
+    }
+  }
+}
+#endif
+
+TEST_F(caesar_encrypt_tests, prepared_key_reduces_shift) {
+  const auto key { crypto.prepare_key("27") };
+
+  ASSERT_EQ("IfMmP, XpSmE", crypto.encrypt("HeLlO, WoRlD", *key));
+  ASSERT_EQ("HeLlO, WoRlD", crypto.decrypt("IfMmP, XpSmE", *key));
+}
+
+TEST_F(caesar_encrypt_tests, error_when_prepared_key_is_not_number) { ASSERT_ANY_THROW(crypto.prepare_key("one")); }
+
+TEST_F(caesar_encrypt_tests, encrypt_into_reuses_output_buffer) {
+  const auto key { crypto.prepare_key("1") };
+  std::array<std::byte, 16> output;
+
+  for (const std::string_view text : { "HeLlO, WoRlD", "abc" }) {
+    const auto size { crypto.encrypt_into(std::as_bytes(std::span { text }), output, *key) };
+
+    ASSERT_EQ(crypto.encrypt(std::string { text }, 1), std::string_view(reinterpret_cast<char *>(output.data()), size));
+  }
+}
+
+TEST_F(caesar_encrypt_tests, error_when_output_buffer_is_too_small) {
+  const auto key { crypto.prepare_key("1") };
+  std::array<std::byte, 4> output;
+
+  ASSERT_ANY_THROW(crypto.encrypt_into(std::as_bytes(std::span { "Hello", 5 }), output, *key));
+}
+
+TEST_F(caesar_decrypt_tests, decrypt_in_place) {
+  const auto key { crypto.prepare_key("1") };
+  std::string text { "IfMmP, XpSmE" };
+
+  crypto.decrypt_in_place(std::as_writable_bytes(std::span { text }), *key);
+
+  ASSERT_EQ("HeLlO, WoRlD", text);
+}
+
+TEST_F(caesar_encrypt_tests, try_encrypt_returns_output) {
+  const auto key { crypto.prepare_key("1") };
+
+  const auto actual { crypto.try_encrypt("HeLlO, WoRlD", *key) };
+
+  ASSERT_TRUE(actual.has_value());
+  ASSERT_EQ("IfMmP, XpSmE", *actual);
+}
+
+TEST_F(caesar_encrypt_tests, try_encrypt_returns_error_code_without_throwing) {
+  const auto key { crypto.prepare_key("1") };
+
+  const auto actual { crypto.try_encrypt("Hello 1", *key) };
+
+  ASSERT_FALSE(actual.has_value());
+  ASSERT_EQ(broken_text_error, actual.error());
+}
+
+TEST_F(caesar_decrypt_tests, try_decrypt_into_reports_too_small_output_buffer) {
+  const auto key { crypto.prepare_key("1") };
+  std::array<std::byte, 4> output;
+
+  const auto actual { crypto.try_decrypt_into(std::as_bytes(std::span { "Hello", 5 }), output, *key) };
+
+  ASSERT_EQ(output_buffer_is_too_small_error, actual.error());
+}
+
+TEST_F(caesar_encrypt_tests, throwing_api_keeps_error_code) {
+  const auto key { crypto.prepare_key("1") };
+  std::array<std::byte, 8> output;
+
+  try {
+    crypto.encrypt_into(std::as_bytes(std::span { "Hello 1", 7 }), output, *key);
+    FAIL();
+  } catch (const CryptoError &e) {
+    ASSERT_EQ(broken_text_error, e.get_error());
+  }
+}
+
+TEST_F(caesar_encrypt_tests, error_when_key_is_of_other_strategy) {
+  const auto key { VigenereCryptoStrategy {}.prepare_key("BYE") };
+  std::array<std::byte, 8> output;
+
+  ASSERT_THROW(crypto.encrypt("HELLO", *key), CryptoError);
+  ASSERT_EQ(foreign_key_error, crypto.try_encrypt_into(std::as_bytes(std::span { "HELLO", 5 }), output, *key).error());
+}